@@ -35,80 +35,171 @@
  */
 #include <stdint.h>
 #include <stddef.h>
+#include <stdio.h>  // For printf()
 #include <ti/drivers/Timer.h>
 #include <ti/drivers/GPIO.h>
+#include <ti/drivers/dpl/HwiP.h>
 #include "ti_drivers_config.h"
+#include "LowPower.h"
+#include "Debounce.h"
+#include "EventQueue.h"
+#include "LogQueue.h"
+#include "MorseCode.h"
+#include "MorseMessages.h"
+#include "MorseTiming.h"
 
-/* Define the state machine states */
-typedef enum {STATE_DOT, STATE_DASH, STATE_INTER_CHAR, STATE_INTER_WORD} State;
-State currentState = STATE_DOT;
+/* Messages SW4 steps through, packed into flash by host/tools/morse_pack */
+#define MESSAGE_COUNT       (sizeof(MorseMessages_table) / sizeof(MorseMessages_table[0]))
 
-/* Define Morse code messages */
-char* morseMessageSOS = "...---...";
-char* morseMessageOK = "---.-";
-char* currentMessage = "...---...";
-int currentIndex = 0;
-uint32_t timerPeriod = 500000;
-volatile int messageChangePending = 0;  /* Flag to indicate pending message change */
+/* Speeds SW2 steps through: character WPM and Farnsworth effective WPM, the first at boot */
+#ifndef MORSE_SPEEDS
+#define MORSE_SPEEDS        { 5, 5 }, { 13, 13 }, { 20, 10 }, { 40, 40 }
+#endif
+
+static const uint8_t morseSpeeds[][2] = { MORSE_SPEEDS };
+#define SPEED_COUNT         (sizeof(morseSpeeds) / sizeof(morseSpeeds[0]))
+
+/* LED levels of each timer step, by 2 * symbol + step, as MorseTiming periods are */
+static const uint8_t redLevels[8] = {
+    CONFIG_GPIO_LED_ON, CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF,
+    CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF
+};
+static const uint8_t greenLevels[8] = {
+    CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_ON, CONFIG_GPIO_LED_OFF,
+    CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF, CONFIG_GPIO_LED_OFF
+};
+
+/* Two timing tables: timerCallback plays from one while the main loop computes a new speed into the other */
+static MorseTiming timings[2];
+static const MorseTiming *volatile timing = &timings[0];
+static size_t currentSpeed = 0;         /* morseSpeeds[] index; main loop only */
+
+const MorseCode_Message *currentMessage = &MorseMessages_table[0];
+static uint32_t currentStep = 0;        /* Next timer step of currentMessage, two per symbol */
+static size_t nextMessage = 0;          /* MorseMessages_table[] index to switch to */
+volatile int messageChangePending = 0;  /* Set by the main loop, cleared by timerCallback */
+
+#define BUTTON_MESSAGE 0  /* Debounce id of the message button, SW4 */
+#define BUTTON_SPEED   1  /* Debounce id of the speed button, SW2 */
+#define EVENT_BATCH    4  /* Events handled per EventQueue_take() */
+
+/* 1 = timerCallback posts its log records for the main loop to print; 0 = printf() in the ISR, for comparison */
+#ifndef MORSE_LOG_DEFERRED
+#define MORSE_LOG_DEFERRED  1
+#endif
+
+/* 1 = each step ends at an absolute deadline on the free-running timebase; 0 = one period after
+   timerCallback ran, as before, so that its latency adds up, for comparison */
+#ifndef MORSE_SCHEDULE_ABSOLUTE
+#define MORSE_SCHEDULE_ABSOLUTE  1
+#endif
+
+/* Shortest period timerCallback arms when it is running late: one microsecond */
+#define MIN_PERIOD_COUNTS  MorseTiming_COUNTS_PER_US
+
+/* LogQueue message ids */
+#define LOG_MESSAGE    0  /* value: the new message */
+#define LOG_ISR_TIME   1  /* timerCallback duration so far */
+#define LOG_EDGE_TIME  2  /* LED edge times against their ideal times so far */
+#define LOG_DUTY       3  /* Time awake against time asleep in WFI so far */
+#define LOG_BUTTONS    4  /* Button interrupts against presses */
+#define LOG_EVENTS     5  /* EventQueue overruns and high-water mark */
+
+/* timerCallback duration in cycles, kept by timerCallback */
+static uint32_t isrCalls = 0;
+static uint32_t isrMaxCycles = 0;
+static uint64_t isrTotalCycles = 0;
+
+/* Free-running CONFIG_TIMER_1 counting up at 80 MHz: the time base of the step deadlines */
+static Timer_Handle timebase;
+static uint32_t deadline;  /* Ideal time of the edge timerCallback plays next, in timebase counts */
+
+/* Actual LED edge times less their ideal times, in timebase counts, kept by timerCallback */
+static uint32_t edgeCount = 0;
+static uint32_t edgeMaxLate = 0;
+static uint64_t edgeTotalLate = 0;
+static int32_t edgeLastError = 0;  /* The latest edge: the error accumulated since boot */
 
 
 /*
  *  ======== timerCallback ========
  *  Timer callback function
- *  This function is called at each timer interrupt to update the state machine
- *  and control the LED blinking according to the Morse code pattern.
+ *  This function is called at each timer interrupt to play the next step
+ *  of the packed message: a symbol, or the gap after it, with its LED
+ *  levels and its period for the current speed, all from tables. Message
+ *  changes take effect at the end of the message, after the word gap.
  */
 void timerCallback(Timer_Handle myHandle, int_fast16_t status) {
+    uint32_t start = LogQueue_now();
+    uint32_t cycles, now, remaining;
+    int32_t error;
+    unsigned slot;
 
-    if (currentState == STATE_INTER_WORD && messageChangePending) {
-        // Toggle the Morse code message
-        currentMessage = (currentMessage == morseMessageSOS) ? morseMessageOK : morseMessageSOS;
-        currentIndex = 0;  /* Reset the index */
-        messageChangePending = 0;  /* Clear the pending flag */
-        GPIO_toggle(CONFIG_GPIO_LED_1);  /* Toggle the green LED to indicate a change */
-        printf("Current message: %s\n", currentMessage);  /* Print the current message for debugging */
+    EventQueue_post(EventQueue_TICK, 0, 0, 0);  /* The main loop polls the buttons on each step */
+
+    if (currentStep == 2u * currentMessage->symbols) {  /* After the word gap */
+        currentStep = 0;
+        if (messageChangePending) {
+            currentMessage = &MorseMessages_table[nextMessage];
+            messageChangePending = 0;  /* Clear the pending flag */
+#if MORSE_LOG_DEFERRED
+            LogQueue_post(LOG_MESSAGE, 0, (uintptr_t)currentMessage->text);  /* Printed by the main loop */
+#else
+            printf("Current message: %s\n", currentMessage->text);  /* Print the current message for debugging */
+#endif
+            LogQueue_post(LOG_ISR_TIME, 0, 0);
+            LogQueue_post(LOG_EDGE_TIME, 0, 0);
+            LogQueue_post(LOG_DUTY, 0, 0);
+            LogQueue_post(LOG_BUTTONS, 0, 0);
+            LogQueue_post(LOG_EVENTS, 0, 0);
+        }
     }
 
-    switch (currentState) {
-        case STATE_DOT:
-            GPIO_write(CONFIG_GPIO_LED_0, CONFIG_GPIO_LED_ON);   /* Turn on red LED for dot */
-            GPIO_write(CONFIG_GPIO_LED_1, CONFIG_GPIO_LED_OFF);  /* Ensure green LED is off */
-            currentState = STATE_INTER_CHAR;
-            timerPeriod = 500000; /* Dot duration */
-            break;
-        case STATE_DASH:
-            GPIO_write(CONFIG_GPIO_LED_0, CONFIG_GPIO_LED_OFF);  /* Ensure red LED is off */
-            GPIO_write(CONFIG_GPIO_LED_1, CONFIG_GPIO_LED_ON);   /* Turn on green LED for dash */
-            currentState = STATE_INTER_CHAR;
-            timerPeriod = 1500000; /* Dash duration */
-            break;
-        case STATE_INTER_CHAR:
-            GPIO_write(CONFIG_GPIO_LED_0, CONFIG_GPIO_LED_OFF);  /* Turn off red LED */
-            GPIO_write(CONFIG_GPIO_LED_1, CONFIG_GPIO_LED_OFF);  /* Turn off green LED */
-            currentIndex++;
-            if (currentMessage[currentIndex] == '\0') {  /* If end of message */
-                currentState = STATE_INTER_WORD;
-                timerPeriod = 3500000; /* Inter-word gap duration */
-            } else { /* More characters in message */
-                currentState = (currentMessage[currentIndex] == '.') ? STATE_DOT : STATE_DASH;
-                timerPeriod = 500000; /* Standard duration */
-            }
-            break;
-        case STATE_INTER_WORD:
-            GPIO_write(CONFIG_GPIO_LED_0, CONFIG_GPIO_LED_OFF);  /* Turn off red LED */
-            GPIO_write(CONFIG_GPIO_LED_1, CONFIG_GPIO_LED_OFF);  /* Turn off green LED */
-            currentIndex = 0;  /* Reset to start of message */
-            currentState = (currentMessage[currentIndex] == '.') ? STATE_DOT : STATE_DASH;
-            timerPeriod = 500000; /* Standard duration */
-            break;
+    /* Step 2k is symbol k with its LEDs lit, step 2k + 1 the gap after it */
+    slot = (MorseCode_symbol(currentMessage->bits, currentStep >> 1) << 1) | (currentStep & 1);
+    currentStep++;
+    now = Timer_getCount(timebase);
+    GPIO_write(CONFIG_GPIO_LED_0, redLevels[slot]);    /* Red LED for dot */
+    GPIO_write(CONFIG_GPIO_LED_1, greenLevels[slot]);  /* Green LED for dash */
+
+    error = (int32_t)(now - deadline);
+    edgeCount++;
+    edgeLastError = error;
+    if (error > 0) {
+        edgeTotalLate += (uint32_t)error;
+        if ((uint32_t)error > edgeMaxLate) {
+            edgeMaxLate = (uint32_t)error;
+        }
+    }
+
+    /* The next deadline follows from this one, not from now, so no latency carries over */
+    deadline += timing->periods[slot];
+#if MORSE_SCHEDULE_ABSOLUTE
+    remaining = deadline - now;
+    if ((int32_t)remaining < MIN_PERIOD_COUNTS) {
+        remaining = MIN_PERIOD_COUNTS;  /* More than a step late: catch up as soon as possible */
+    }
+#else
+    remaining = timing->periods[slot];
+#endif
+    Timer_setPeriod(myHandle, Timer_PERIOD_COUNTS, remaining);
+
+    cycles = LogQueue_now() - start;
+    isrCalls++;
+    isrTotalCycles += cycles;
+    if (cycles > isrMaxCycles) {
+        isrMaxCycles = cycles;
     }
-    Timer_setPeriod(myHandle, Timer_PERIOD_US, timerPeriod); /* Update the timer period */
 }
 
 /*
  *  ======== initTimer ========
  *  Function to initialize and start the timer
  *  This function sets up the timer with the specified parameters and starts it.
+ *  CONFIG_TIMER_1 runs free as the time base of the step deadlines, and
+ *  CONFIG_TIMER_0 interrupts at each step. The Timer driver has no
+ *  compare event, so timerCallback re-arms CONFIG_TIMER_0 with the time
+ *  left to the next deadline on the time base.
  */
 void initTimer(void) {
     Timer_Handle timer0;
@@ -116,8 +207,18 @@ void initTimer(void) {
 
     Timer_init();
     Timer_Params_init(&params);
-    params.period = timerPeriod;
-    params.periodUnits = Timer_PERIOD_US;
+    params.period = 0xFFFFFFFF;
+    params.periodUnits = Timer_PERIOD_COUNTS;
+    params.timerMode = Timer_FREE_RUNNING;
+
+    timebase = Timer_open(CONFIG_TIMER_1, &params);
+    if (timebase == NULL || Timer_start(timebase) == Timer_STATUS_ERROR) {
+        while (1) {}
+    }
+
+    Timer_Params_init(&params);
+    params.period = timing->periods[0];  /* The first step starts after one unit */
+    params.periodUnits = Timer_PERIOD_COUNTS;
     params.timerMode = Timer_CONTINUOUS_CALLBACK;
     params.timerCallback = timerCallback;
 
@@ -126,6 +227,7 @@ void initTimer(void) {
         while (1) {}
     }
 
+    deadline = Timer_getCount(timebase) + timing->periods[0];
     if (Timer_start(timer0) == Timer_STATUS_ERROR) {
         while (1) {}
     }
@@ -136,12 +238,156 @@ void initTimer(void) {
  *  GPIO button interrupt callback function
  *  This function is called when the button is pressed and toggles the Morse code message
  *  only after the current message is complete.
+ *  Contact bounce is masked by Debounce, so one press requests one change.
  */
 void gpioButtonFxn1(uint_least8_t index) {
-    messageChangePending = 1;  /* Set the pending message change flag */
+    Debounce_edge(BUTTON_MESSAGE);  /* Timestamp the edge and mask the bounce; the main loop confirms it */
+}
+
+/*
+ *  ======== gpioButtonFxn0 ========
+ *  SW2 interrupt callback: steps the Morse speed, debounced like SW4.
+ */
+void gpioButtonFxn0(uint_least8_t index) {
+    Debounce_edge(BUTTON_SPEED);
+}
+
+/*
+ *  ======== setSpeed ========
+ *  Compute the timing of morseSpeeds[speed] into the table timerCallback
+ *  is not using, then hand it over; the next step plays at the new speed.
+ */
+static void setSpeed(size_t speed) {
+    MorseTiming *next = (timing == &timings[0]) ? &timings[1] : &timings[0];
+
+    if (MorseTiming_init(next, morseSpeeds[speed][0], morseSpeeds[speed][1])) {
+        currentSpeed = speed;
+        timing = next;
+        printf("Speed: %u WPM, %u WPM effective\n", (unsigned)next->wpm, (unsigned)next->effectiveWpm);
+    }
+}
+
+/*
+ *  ======== handleEvents ========
+ *  Drain the event queue: each step tick polls the buttons. A confirmed
+ *  SW4 press requests the next message at the next inter-word gap, an SW2
+ *  press changes to the next speed at once.
+ */
+static void handleEvents(void) {
+    EventQueue_Event events[EVENT_BATCH];
+    size_t count, i;
+
+    while ((count = EventQueue_take(events, EVENT_BATCH)) != 0) {
+        for (i = 0; i < count; i++) {
+            switch (events[i].type) {
+                case EventQueue_TICK:
+                    Debounce_poll();
+                    break;
+                case EventQueue_BUTTON:
+                    Debounce_handleEdge(events[i].arg, events[i].time);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    if (Debounce_take(BUTTON_MESSAGE) != 0 && !messageChangePending) {
+        nextMessage = (size_t)(currentMessage - MorseMessages_table + 1) % MESSAGE_COUNT;
+        messageChangePending = 1;  /* Set the pending message change flag */
+    }
+    if (Debounce_take(BUTTON_SPEED) != 0) {
+        setSpeed((currentSpeed + 1) % SPEED_COUNT);
+    }
 }
 
 
+/*
+ *  ======== printLog ========
+ *  Print one deferred log record; called by the main loop. Records lost
+ *  to a full LogQueue are reported with the next record that gets through.
+ */
+static void printLog(const LogQueue_Record *record) {
+    static uint32_t droppedReported = 0;
+    LogQueue_Stats logStats;
+    uint32_t calls, maxCycles, edges, maxLate;
+    uint64_t totalCycles, totalLate;
+    int32_t lastError;
+    uint32_t duty;
+    LowPower_Stats powerStats;
+    Debounce_Stats buttonStats;
+    EventQueue_Stats eventStats;
+    uint_least8_t button;
+    uintptr_t key;
+
+    LogQueue_getStats(&logStats);
+    if (logStats.dropped != droppedReported) {
+        printf("Log: %lu records dropped on a full queue, %u of %u queued at most\n",
+               (unsigned long)(logStats.dropped - droppedReported), (unsigned)logStats.highWater,
+               (unsigned)LogQueue_SIZE);
+        droppedReported = logStats.dropped;
+    }
+
+    switch (record->id) {
+        case LOG_MESSAGE:
+            printf("Current message: %s\n", (const char *)record->value);
+            break;
+        case LOG_ISR_TIME:
+            key = HwiP_disable();
+            calls = isrCalls;
+            maxCycles = isrMaxCycles;
+            totalCycles = isrTotalCycles;
+            HwiP_restore(key);
+            printf("timerCallback: %lu calls, mean %lu cycles, max %lu cycles (%lu us)\n",
+                   (unsigned long)calls, (unsigned long)(calls ? totalCycles / calls : 0),
+                   (unsigned long)maxCycles, (unsigned long)(maxCycles / LogQueue_COUNTS_PER_US));
+            break;
+        case LOG_EDGE_TIME:
+            key = HwiP_disable();
+            edges = edgeCount;
+            maxLate = edgeMaxLate;
+            totalLate = edgeTotalLate;
+            lastError = edgeLastError;
+            HwiP_restore(key);
+            printf("LED edges: %lu, late mean %lu us, max %lu us; last edge %ld us from its ideal time\n",
+                   (unsigned long)edges,
+                   (unsigned long)(edges ? totalLate / edges / MorseTiming_COUNTS_PER_US : 0),
+                   (unsigned long)(maxLate / MorseTiming_COUNTS_PER_US),
+                   (long)(lastError / MorseTiming_COUNTS_PER_US));
+            break;
+        case LOG_DUTY:
+            duty = LowPower_dutyPermille();
+            LowPower_getStats(&powerStats);
+            printf("Awake %lu.%lu%%: %lu sleeps, active %lu us, idle %lu ms\n",
+                   (unsigned long)(duty / 10), (unsigned long)(duty % 10), (unsigned long)powerStats.sleeps,
+                   (unsigned long)(powerStats.activeTicks * 1000000 / LowPower_TICKS_PER_SEC),
+                   (unsigned long)(powerStats.idleTicks * 1000 / LowPower_TICKS_PER_SEC));
+            break;
+        case LOG_BUTTONS:
+            for (button = 0; Debounce_getStats(button, &buttonStats); button++) {
+                printf("Button %u: %lu interrupts, at least %lu bounce masked, %lu presses, %lu rejected\n",
+                       (unsigned)button, (unsigned long)buttonStats.interrupts, (unsigned long)buttonStats.suppressed,
+                       (unsigned long)buttonStats.presses, (unsigned long)buttonStats.rejected);
+            }
+            break;
+        case LOG_EVENTS:
+            EventQueue_getStats(&eventStats);
+            printf("Events %lu tick, %lu button; overruns %lu/%lu; high water %u of %u\n",
+                   (unsigned long)eventStats.posted[EventQueue_TICK], (unsigned long)eventStats.posted[EventQueue_BUTTON],
+                   (unsigned long)eventStats.overruns[EventQueue_TICK], (unsigned long)eventStats.overruns[EventQueue_BUTTON],
+                   (unsigned)eventStats.highWater, (unsigned)EventQueue_SIZE);
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ *  ======== workPending ========
+ *  Events or log records waiting; the main loop sleeps only when neither is.
+ */
+static bool workPending(void) {
+    return EventQueue_pending() || LogQueue_pending();
+}
 
 /*
  *  ======== mainThread ========
@@ -150,22 +396,45 @@ void gpioButtonFxn1(uint_least8_t index) {
  *  installs the button callback, and starts the timer.
  */
 void *mainThread(void *arg0) {
+    Debounce_Params debounceParams;
+
+    EventQueue_init();  /* Before any interrupt can post */
+    LogQueue_init();
     GPIO_init();
     Timer_init();
 
     GPIO_setConfig(CONFIG_GPIO_LED_0, GPIO_CFG_OUT_STD | GPIO_CFG_OUT_LOW);
     GPIO_setConfig(CONFIG_GPIO_LED_1, GPIO_CFG_OUT_STD | GPIO_CFG_OUT_LOW);
     GPIO_setConfig(CONFIG_GPIO_BUTTON_1, GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_FALLING);
+    GPIO_setConfig(CONFIG_GPIO_BUTTON_0, GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_FALLING);
 
     GPIO_write(CONFIG_GPIO_LED_0, CONFIG_GPIO_LED_OFF);
     GPIO_write(CONFIG_GPIO_LED_1, CONFIG_GPIO_LED_OFF);
 
+    /* The step tick (one unit, 240 ms at 5 WPM) is the debounce poll, too slow to see a short
+       press close: accept an edge that the poll finds already released. No repeat. */
+    Debounce_Params_init(&debounceParams);
+    debounceParams.trustAfterMs = 100;
+    debounceParams.repeatDelayMs = 0;
+    Debounce_open(BUTTON_MESSAGE, CONFIG_GPIO_BUTTON_1, &debounceParams);
+    Debounce_open(BUTTON_SPEED, CONFIG_GPIO_BUTTON_0, &debounceParams);
+
     GPIO_setCallback(CONFIG_GPIO_BUTTON_1, gpioButtonFxn1);
     GPIO_enableInt(CONFIG_GPIO_BUTTON_1);
+    GPIO_setCallback(CONFIG_GPIO_BUTTON_0, gpioButtonFxn0);
+    GPIO_enableInt(CONFIG_GPIO_BUTTON_0);
+
+    if (!MorseTiming_init(&timings[0], morseSpeeds[0][0], morseSpeeds[0][1])) {
+        while (1) {}
+    }
 
     initTimer();
+    LowPower_init();
 
     while (1) {
-        /* Main loop */
+        /* Main loop - the LEDs run in timerCallback; sleep until an interrupt posts an event */
+        LowPower_idle(workPending);
+        handleEvents();
+        LogQueue_drain(printLog, LogQueue_SIZE);  /* Deferred printf() out of timerCallback */
     }
 }
@@ -0,0 +1,33 @@
+/*
+ *  ======== CycleCounter.h ========
+ *  The Cortex-M DWT cycle counter, for the modules that timestamp with it.
+ *
+ *  CycleCounter_DWT is 1 when compiling for a Cortex-M core and 0 for the
+ *  host build, which times with clock_gettime() instead. __ARM_ARCH alone
+ *  is not enough: it is also set on aarch64 and Cortex-A Linux hosts,
+ *  where these addresses are not mapped.
+ */
+
+#ifndef CycleCounter_h
+#define CycleCounter_h
+
+#include <stdint.h>
+
+#if defined(__TI_ARM__) || (defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M')
+#define CycleCounter_DWT  1
+#else
+#define CycleCounter_DWT  0
+#endif
+
+#if CycleCounter_DWT
+
+/* Cortex-M debug registers */
+#define DEMCR            (*(volatile uint32_t *)0xE000EDFC)
+#define DEMCR_TRCENA     (1u << 24)
+#define DWT_CTRL         (*(volatile uint32_t *)0xE0001000)
+#define DWT_CTRL_CYCCNT  (1u << 0)
+#define DWT_CYCCNT       (*(volatile uint32_t *)0xE0001004)
+
+#endif
+
+#endif /* CycleCounter_h */
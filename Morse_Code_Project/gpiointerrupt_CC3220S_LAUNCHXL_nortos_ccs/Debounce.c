@@ -0,0 +1,248 @@
+/*
+ *  ======== Debounce.c ========
+ *  Per-button state machine:
+ *
+ *    IDLE       interrupt enabled, waiting for a falling edge
+ *    ARMED      edge seen and interrupt masked; waiting settleMs to confirm
+ *    HELD       press confirmed; repeats are generated while it is held
+ *    RELEASING  contact open; the interrupt is unmasked after settleMs
+ *
+ *  The ISR only masks the pin and posts the edge; the state machine itself
+ *  belongs to the main loop. Timestamps are the low 32 bits of the slow
+ *  clock and are only compared as differences, which stay correct across
+ *  its 36 hour wrap. Buttons are active low, as on the LaunchPad.
+ */
+
+#include <stddef.h>
+
+#include <ti/drivers/GPIO.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/devices/cc32xx/driverlib/prcm.h>
+
+#include "Debounce.h"
+#include "EventQueue.h"
+
+#define TICKS_PER_SEC  32768u  /* PRCM slow clock */
+#define PRESSED        0
+
+typedef enum {
+    STATE_IDLE,
+    STATE_ARMED,
+    STATE_HELD,
+    STATE_RELEASING
+} State;
+
+typedef struct {
+    bool              open;
+    uint_least8_t     gpioIndex;
+    State             state;
+    uint32_t          edgeTicks;     /* Falling edge that armed the button */
+    uint32_t          releaseTicks;  /* Last time the contact was seen pressed while releasing */
+    uint32_t          nextRepeat;
+    uint32_t          interval;      /* Current repeat interval */
+    uint32_t          settle;        /* Params, converted to slow clock ticks */
+    uint32_t          trustAfter;
+    uint32_t          repeatDelay;
+    uint32_t          repeatStart;
+    uint32_t          repeatMin;
+    uint32_t          pending;       /* Presses and repeats not yet taken */
+    Debounce_Stats    stats;         /* interrupts is written by Debounce_edge() */
+} Button;
+
+static Button buttons[Debounce_MAX_BUTTONS];
+
+/*
+ *  ======== msToTicks ========
+ */
+static uint32_t msToTicks(uint16_t ms) {
+    return ((uint32_t)ms * TICKS_PER_SEC + 999) / 1000;
+}
+
+/*
+ *  ======== Debounce_Params_init ========
+ *  20 ms settle, no edge-only acceptance, repeat after 500 ms held starting
+ *  at 300 ms and speeding up to 100 ms.
+ */
+void Debounce_Params_init(Debounce_Params *params) {
+    params->settleMs = 20;
+    params->trustAfterMs = 0;
+    params->repeatDelayMs = 500;
+    params->repeatStartMs = 300;
+    params->repeatMinMs = 100;
+}
+
+/*
+ *  ======== Debounce_open ========
+ *  The pin's interrupt and callback are set up by the caller; the callback
+ *  must call Debounce_edge() with the same id.
+ */
+bool Debounce_open(uint_least8_t id, uint_least8_t gpioIndex, const Debounce_Params *params) {
+    Button *button;
+
+    if (id >= Debounce_MAX_BUTTONS) {
+        return false;
+    }
+    button = &buttons[id];
+    button->gpioIndex = gpioIndex;
+    button->state = STATE_IDLE;
+    button->settle = msToTicks(params->settleMs);
+    button->trustAfter = msToTicks(params->trustAfterMs);
+    button->repeatDelay = msToTicks(params->repeatDelayMs);
+    button->repeatStart = msToTicks(params->repeatStartMs);
+    button->repeatMin = msToTicks(params->repeatMinMs);
+    button->pending = 0;
+    button->open = true;
+    return true;
+}
+
+/*
+ *  ======== Debounce_edge ========
+ *  Called from the button's GPIO interrupt callback. Returns true if the
+ *  edge was posted as a possible press.
+ */
+bool Debounce_edge(uint_least8_t id) {
+    Button *button;
+
+    if (id >= Debounce_MAX_BUTTONS) {
+        return false;
+    }
+    button = &buttons[id];
+    GPIO_disableInt(button->gpioIndex);  /* Bounce stops here */
+    button->stats.interrupts++;
+    if (!EventQueue_post(EventQueue_BUTTON, id, 0, (uint32_t)PRCMSlowClkCtrFastGet())) {
+        GPIO_enableInt(button->gpioIndex);  /* Lost to a full queue; do not stay masked */
+        return false;
+    }
+    return true;
+}
+
+/*
+ *  ======== Debounce_handleEdge ========
+ *  Main loop side of Debounce_edge(), with the event's timestamp.
+ */
+void Debounce_handleEdge(uint_least8_t id, uint32_t time) {
+    Button *button;
+
+    if (id >= Debounce_MAX_BUTTONS) {
+        return;
+    }
+    button = &buttons[id];
+    if (button->state != STATE_IDLE) {
+        button->stats.leaked++;
+        return;
+    }
+    button->edgeTicks = time;
+    button->state = STATE_ARMED;
+}
+
+/*
+ *  ======== confirm ========
+ */
+static void confirm(Button *button, uint32_t now) {
+    button->pending++;
+    button->stats.presses++;
+    button->nextRepeat = now + button->repeatDelay;
+    button->interval = button->repeatStart;
+}
+
+/*
+ *  ======== Debounce_poll ========
+ *  Advance every button; call from a periodic tick shorter than settleMs
+ *  plus the shortest press to be recognised.
+ */
+void Debounce_poll(void) {
+    uint32_t now = (uint32_t)PRCMSlowClkCtrFastGet();
+    uint_least8_t i;
+
+    for (i = 0; i < Debounce_MAX_BUTTONS; i++) {
+        Button *button = &buttons[i];
+        bool pressed;
+
+        if (!button->open || button->state == STATE_IDLE) {
+            continue;
+        }
+        pressed = GPIO_read(button->gpioIndex) == PRESSED;
+
+        switch (button->state) {
+            case STATE_ARMED:
+                if (now - button->edgeTicks < button->settle) {
+                    break;
+                }
+                if (pressed) {
+                    confirm(button, now);
+                    button->state = STATE_HELD;
+                    break;
+                }
+                /* Open again: a glitch, or a short press the poll was too late to see */
+                button->stats.suppressed++;
+                if (button->trustAfter != 0 && now - button->edgeTicks > button->trustAfter) {
+                    confirm(button, now);
+                } else {
+                    button->stats.rejected++;
+                }
+                button->releaseTicks = now;
+                button->state = STATE_RELEASING;
+                break;
+
+            case STATE_HELD:
+                if (!pressed) {
+                    button->releaseTicks = now;
+                    button->state = STATE_RELEASING;
+                } else if (button->repeatDelay != 0 && (int32_t)(now - button->nextRepeat) >= 0) {
+                    button->pending++;
+                    button->stats.repeats++;
+                    button->nextRepeat = now + button->interval;
+                    button->interval = button->interval * 3 / 4;
+                    if (button->interval < button->repeatMin) {
+                        button->interval = button->repeatMin;
+                    }
+                }
+                break;
+
+            case STATE_RELEASING:
+                if (pressed) {
+                    button->stats.suppressed++;  /* Release bounce, restart the settle time */
+                    button->releaseTicks = now;
+                } else if (now - button->releaseTicks >= button->settle) {
+                    button->state = STATE_IDLE;
+                    GPIO_clearInt(button->gpioIndex);  /* Drop edges latched while masked */
+                    GPIO_enableInt(button->gpioIndex);
+                }
+                break;
+
+            case STATE_IDLE:
+                break;
+        }
+    }
+}
+
+/*
+ *  ======== Debounce_take ========
+ *  Returns the presses and repeats confirmed since the last call.
+ */
+uint32_t Debounce_take(uint_least8_t id) {
+    uint32_t count;
+
+    if (id >= Debounce_MAX_BUTTONS) {
+        return 0;
+    }
+    count = buttons[id].pending;
+    buttons[id].pending = 0;
+    return count;
+}
+
+/*
+ *  ======== Debounce_getStats ========
+ *  Returns false if id is not a button.
+ */
+bool Debounce_getStats(uint_least8_t id, Debounce_Stats *out) {
+    uintptr_t key;
+
+    if (id >= Debounce_MAX_BUTTONS) {
+        return false;
+    }
+    key = HwiP_disable();
+    *out = buttons[id].stats;
+    HwiP_restore(key);
+    return true;
+}
@@ -0,0 +1,120 @@
+/*
+ *  ======== EventQueue.c ========
+ *  Ring of EventQueue_SIZE slots with free-running 32-bit indices: head
+ *  is written only by EventQueue_post(), tail only by EventQueue_take(),
+ *  and head - tail is the fill level even across wrap-around.
+ *
+ *  The slots and indices are volatile, so the compiler keeps each slot
+ *  write ahead of the head store that publishes it, and each slot read
+ *  ahead of the tail store that frees it. On the single-core Cortex-M4
+ *  that program order is all the ordering needed; no barrier or
+ *  interrupt masking is involved.
+ */
+
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "EventQueue.h"
+
+#define MASK  (EventQueue_SIZE - 1)
+
+static volatile EventQueue_Event slots[EventQueue_SIZE];
+static volatile uint32_t head;  /* Next slot to fill; producer only */
+static volatile uint32_t tail;  /* Next slot to read; consumer only */
+
+static EventQueue_Stats stats;
+
+/*
+ *  ======== EventQueue_init ========
+ *  Call before the producing interrupts are enabled.
+ */
+void EventQueue_init(void) {
+    int i;
+
+    head = 0;
+    tail = 0;
+    for (i = 0; i < EventQueue_TYPE_COUNT; i++) {
+        stats.posted[i] = 0;
+        stats.overruns[i] = 0;
+    }
+    stats.batches = 0;
+    stats.maxBatch = 0;
+    stats.highWater = 0;
+}
+
+/*
+ *  ======== EventQueue_post ========
+ *  Producer side, interrupt context. Returns false, and counts an overrun,
+ *  if the queue is full.
+ */
+bool EventQueue_post(EventQueue_Type type, uint8_t arg, uint16_t value, uint32_t time) {
+    uint32_t h = head;
+    uint32_t level = h - tail;
+    volatile EventQueue_Event *slot;
+
+    if (level >= EventQueue_SIZE) {
+        stats.overruns[type]++;
+        return false;
+    }
+    slot = &slots[h & MASK];
+    slot->type = (uint8_t)type;
+    slot->arg = arg;
+    slot->value = value;
+    slot->time = time;
+    head = h + 1;  /* Publish */
+
+    stats.posted[type]++;
+    if (level + 1 > stats.highWater) {
+        stats.highWater = (uint16_t)(level + 1);
+    }
+    return true;
+}
+
+/*
+ *  ======== EventQueue_pending ========
+ *  Tells LowPower_idle() whether events are waiting.
+ */
+bool EventQueue_pending(void) {
+    return head != tail;
+}
+
+/*
+ *  ======== EventQueue_take ========
+ *  Consumer side. Copies up to max events, oldest first, and frees their
+ *  slots with one tail update. Returns the number copied.
+ */
+size_t EventQueue_take(EventQueue_Event *events, size_t max) {
+    uint32_t t = tail;
+    uint32_t available = head - t;
+    size_t i;
+
+    if (available > max) {
+        available = (uint32_t)max;
+    }
+    for (i = 0; i < available; i++) {
+        volatile EventQueue_Event *slot = &slots[(t + i) & MASK];
+
+        events[i].type = slot->type;
+        events[i].arg = slot->arg;
+        events[i].value = slot->value;
+        events[i].time = slot->time;
+    }
+    tail = t + available;  /* Release the slots */
+
+    if (available != 0) {
+        stats.batches++;
+        if (available > stats.maxBatch) {
+            stats.maxBatch = (uint16_t)available;
+        }
+    }
+    return available;
+}
+
+/*
+ *  ======== EventQueue_getStats ========
+ */
+void EventQueue_getStats(EventQueue_Stats *out) {
+    uintptr_t key = HwiP_disable();
+
+    *out = stats;
+    HwiP_restore(key);
+}
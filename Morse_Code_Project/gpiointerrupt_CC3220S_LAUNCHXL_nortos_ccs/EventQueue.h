@@ -0,0 +1,54 @@
+/*
+ *  ======== EventQueue.h ========
+ *  Lock-free single-producer/single-consumer queue of typed events from
+ *  the interrupt handlers to the main loop.
+ *
+ *  The producer side is interrupt context as a whole: the Timer, GPIO, I2C
+ *  and UART interrupts run at the same (default) priority, so they never
+ *  preempt one another and their posts are serialized like a single
+ *  producer's. The consumer is the main loop. Neither side masks
+ *  interrupts; each owns one index and only publishes it after the slot
+ *  it covers has been written or read.
+ */
+
+#ifndef EventQueue_h
+#define EventQueue_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef EventQueue_SIZE
+#define EventQueue_SIZE  32  /* Slots; must be a power of two */
+#endif
+
+typedef enum {
+    EventQueue_TICK,      /* Timer tick */
+    EventQueue_BUTTON,    /* arg: button id, time: edge timestamp */
+    EventQueue_SENSOR,    /* arg: 1 if the read succeeded, value: register */
+    EventQueue_UART_RX,   /* arg: received byte */
+    EventQueue_TYPE_COUNT
+} EventQueue_Type;
+
+typedef struct {
+    uint8_t  type;   /* EventQueue_Type */
+    uint8_t  arg;
+    uint16_t value;
+    uint32_t time;   /* Producer timestamp, if the type has one */
+} EventQueue_Event;
+
+typedef struct {
+    uint32_t posted[EventQueue_TYPE_COUNT];    /* Events queued, by type */
+    uint32_t overruns[EventQueue_TYPE_COUNT];  /* Events dropped on a full queue, by type */
+    uint32_t batches;                          /* EventQueue_take() calls that returned events */
+    uint16_t maxBatch;                         /* Most events returned by one take */
+    uint16_t highWater;                        /* Most events queued at once */
+} EventQueue_Stats;
+
+extern void EventQueue_init(void);
+extern bool EventQueue_post(EventQueue_Type type, uint8_t arg, uint16_t value, uint32_t time);
+extern bool EventQueue_pending(void);
+extern size_t EventQueue_take(EventQueue_Event *events, size_t max);
+extern void EventQueue_getStats(EventQueue_Stats *stats);
+
+#endif /* EventQueue_h */
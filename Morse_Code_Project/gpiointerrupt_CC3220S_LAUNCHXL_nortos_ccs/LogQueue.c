@@ -0,0 +1,132 @@
+/*
+ *  ======== LogQueue.c ========
+ *  Ring of LogQueue_SIZE records with free-running 32-bit indices, as in
+ *  EventQueue: head is written only by LogQueue_post(), tail only by
+ *  LogQueue_drain(), and each is published after the slot it covers.
+ *  The producers are interrupts of one priority, so they never preempt
+ *  one another.
+ */
+
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "LogQueue.h"
+
+#define MASK  (LogQueue_SIZE - 1)
+
+static volatile LogQueue_Record slots[LogQueue_SIZE];
+static volatile uint32_t head;  /* Next slot to fill; producer only */
+static volatile uint32_t tail;  /* Next slot to print; consumer only */
+
+static LogQueue_Stats stats;
+
+#if CycleCounter_DWT
+
+static void counterStart(void) {
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNT;
+}
+
+#else  /* Host build */
+
+#include <time.h>
+
+/*
+ *  ======== LogQueue_hostNow ========
+ */
+uint32_t LogQueue_hostNow(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec) * LogQueue_COUNTS_PER_US / 1000u);
+}
+
+static void counterStart(void) {
+}
+
+#endif
+
+/*
+ *  ======== LogQueue_init ========
+ *  Call before the posting interrupts are enabled.
+ */
+void LogQueue_init(void) {
+    counterStart();
+    head = 0;
+    tail = 0;
+    stats.posted = 0;
+    stats.dropped = 0;
+    stats.printed = 0;
+    stats.highWater = 0;
+}
+
+/*
+ *  ======== LogQueue_post ========
+ *  Producer side, interrupt context. Returns false, and counts a drop, if
+ *  the ring is full.
+ */
+bool LogQueue_post(uint16_t id, uint16_t arg, uintptr_t value) {
+    uint32_t h = head;
+    uint32_t level = h - tail;
+    volatile LogQueue_Record *slot;
+
+    if (level >= LogQueue_SIZE) {
+        stats.dropped++;
+        return false;
+    }
+    slot = &slots[h & MASK];
+    slot->time = LogQueue_now();
+    slot->id = id;
+    slot->arg = arg;
+    slot->value = value;
+    head = h + 1;  /* Publish */
+
+    stats.posted++;
+    if (level + 1 > stats.highWater) {
+        stats.highWater = (uint16_t)(level + 1);
+    }
+    return true;
+}
+
+/*
+ *  ======== LogQueue_pending ========
+ */
+bool LogQueue_pending(void) {
+    return head != tail;
+}
+
+/*
+ *  ======== LogQueue_drain ========
+ *  Consumer side, thread context. Prints up to max records, oldest first,
+ *  freeing each slot once it is copied so the ISRs can post while print
+ *  runs. Returns the number printed.
+ */
+size_t LogQueue_drain(LogQueue_PrintFxn print, size_t max) {
+    LogQueue_Record record;
+    volatile LogQueue_Record *slot;
+    uint32_t t = tail;
+    size_t count = 0;
+
+    while (count < max && t != head) {
+        slot = &slots[t & MASK];
+        record.time = slot->time;
+        record.id = slot->id;
+        record.arg = slot->arg;
+        record.value = slot->value;
+        tail = ++t;  /* Release the slot */
+
+        print(&record);
+        count++;
+    }
+    stats.printed += count;
+    return count;
+}
+
+/*
+ *  ======== LogQueue_getStats ========
+ */
+void LogQueue_getStats(LogQueue_Stats *out) {
+    uintptr_t key = HwiP_disable();
+
+    *out = stats;
+    HwiP_restore(key);
+}
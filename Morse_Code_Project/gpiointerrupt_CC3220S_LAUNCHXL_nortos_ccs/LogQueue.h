@@ -0,0 +1,62 @@
+/*
+ *  ======== LogQueue.h ========
+ *  Deferred logging: interrupt handlers post compact log records, and the
+ *  main loop formats and prints them when it has nothing else to do.
+ *
+ *  printf() from an ISR goes through the CCS CIO breakpoint, which halts
+ *  the core for milliseconds while the debugger services it. LogQueue_post()
+ *  instead stores a 12-byte record (cycle count, message id, two argument
+ *  words) in a lock-free single-producer/single-consumer ring, the same
+ *  scheme as EventQueue, and returns. LogQueue_drain() hands the records to
+ *  the application's print function in thread context.
+ *
+ *  A full ring drops the new record and counts it; the ISR never waits.
+ *  value may carry a pointer to a string that outlives the record, such as
+ *  a literal or a static message.
+ */
+
+#ifndef LogQueue_h
+#define LogQueue_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "CycleCounter.h"
+
+#ifndef LogQueue_SIZE
+#define LogQueue_SIZE           16  /* Records; must be a power of two */
+#endif
+
+#define LogQueue_COUNTS_PER_US  80  /* Cycle counter at 80 MHz */
+
+typedef struct {
+    uint32_t  time;   /* LogQueue_now() when posted */
+    uint16_t  id;     /* Application message id */
+    uint16_t  arg;
+    uintptr_t value;
+} LogQueue_Record;
+
+typedef struct {
+    uint32_t posted;     /* Records queued */
+    uint32_t dropped;    /* Records lost to a full ring */
+    uint32_t printed;    /* Records handed to the print function */
+    uint16_t highWater;  /* Most records queued at once */
+} LogQueue_Stats;
+
+typedef void (*LogQueue_PrintFxn)(const LogQueue_Record *record);
+
+extern void LogQueue_init(void);
+extern bool LogQueue_post(uint16_t id, uint16_t arg, uintptr_t value);
+extern bool LogQueue_pending(void);
+extern size_t LogQueue_drain(LogQueue_PrintFxn print, size_t max);
+extern void LogQueue_getStats(LogQueue_Stats *stats);
+
+#if CycleCounter_DWT
+#define LogQueue_now()  DWT_CYCCNT  /* Started by LogQueue_init() */
+#else
+extern uint32_t LogQueue_hostNow(void);
+#define LogQueue_now()  LogQueue_hostNow()
+#endif
+
+#endif /* LogQueue_h */
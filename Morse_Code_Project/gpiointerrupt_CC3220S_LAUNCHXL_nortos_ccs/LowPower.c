@@ -0,0 +1,81 @@
+/*
+ *  ======== LowPower.c ========
+ *  Puts the core to sleep with WFI between interrupts.
+ *
+ *  The pending check and the WFI run with interrupts masked: an interrupt
+ *  that arrives after the check still wakes WFI (PRIMASK does not block the
+ *  wake-up), and its ISR runs as soon as the mask is restored. Without the
+ *  mask, a timer tick landing between the check and WFI would be slept
+ *  through until the next interrupt.
+ *
+ *  The Timer driver holds a Power constraint that keeps the core out of
+ *  LPDS while a GPTimer is running, so plain WFI sleep is the deepest state
+ *  that still keeps CONFIG_TIMER_0 ticking.
+ */
+
+#include <stddef.h>
+
+#include <ti/devices/cc32xx/inc/hw_types.h>
+#include <ti/devices/cc32xx/driverlib/cpu.h>
+#include <ti/devices/cc32xx/driverlib/prcm.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "LowPower.h"
+
+static uint64_t startTicks;
+static LowPower_Stats stats;
+
+/*
+ *  ======== LowPower_init ========
+ *  Starts the duty cycle measurement window.
+ */
+void LowPower_init(void) {
+    startTicks = PRCMSlowClkCtrFastGet();
+    stats.sleeps = 0;
+    stats.idleTicks = 0;
+    stats.activeTicks = 0;
+}
+
+/*
+ *  ======== LowPower_idle ========
+ *  Sleep until the next interrupt unless pending() reports work already.
+ *  A NULL pending function sleeps unconditionally.
+ */
+void LowPower_idle(LowPower_PendingFxn pending) {
+    uintptr_t key;
+    uint64_t before;
+
+    key = HwiP_disable();
+    if (pending == NULL || !pending()) {
+        before = PRCMSlowClkCtrFastGet();
+        CPUwfi();
+        stats.idleTicks += PRCMSlowClkCtrFastGet() - before;
+        stats.sleeps++;
+    }
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== LowPower_getStats ========
+ */
+void LowPower_getStats(LowPower_Stats *out) {
+    uintptr_t key = HwiP_disable();
+    uint64_t elapsed = PRCMSlowClkCtrFastGet() - startTicks;
+
+    *out = stats;
+    out->activeTicks = (elapsed > stats.idleTicks) ? elapsed - stats.idleTicks : 0;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== LowPower_dutyPermille ========
+ *  Fraction of time awake since LowPower_init(), in tenths of a percent.
+ */
+uint32_t LowPower_dutyPermille(void) {
+    LowPower_Stats now;
+    uint64_t total;
+
+    LowPower_getStats(&now);
+    total = now.activeTicks + now.idleTicks;
+    return (total == 0) ? 1000 : (uint32_t)(now.activeTicks * 1000 / total);
+}
@@ -0,0 +1,77 @@
+/*
+ *  ======== MorseCode.c ========
+ */
+
+#include <string.h>
+
+#include "MorseCode.h"
+
+/* Dots and dashes of the printable ASCII characters from ' ' to '_'; NULL = no Morse code */
+static const char *const codes[64] = {
+    /* ' ' */ NULL,     "-.-.--", ".-..-.", NULL,     "...-..-", NULL,     ".-...",  ".----.",
+    /* '(' */ "-.--.",  "-.--.-", NULL,     ".-.-.",  "--..--",  "-....-", ".-.-.-", "-..-.",
+    /* '0' */ "-----",  ".----",  "..---",  "...--",  "....-",   ".....",  "-....",  "--...",
+    /* '8' */ "---..",  "----.",  "---...", "-.-.-.", NULL,      "-...-",  NULL,     "..--..",
+    /* '@' */ ".--.-.", ".-",     "-...",   "-.-.",   "-..",     ".",      "..-.",   "--.",
+    /* 'H' */ "....",   "..",     ".---",   "-.-",    ".-..",    "--",     "-.",     "---",
+    /* 'P' */ ".--.",   "--.-",   ".-.",    "...",    "-",       "..-",    "...-",   ".--",
+    /* 'X' */ "-..-",   "-.--",   "--..",   NULL,     NULL,      NULL,     NULL,     "..--.-"
+};
+
+/*
+ *  ======== MorseCode_lookup ========
+ *  The dots and dashes of a character, any case; NULL if it has none.
+ */
+const char *MorseCode_lookup(char c) {
+    if (c >= 'a' && c <= 'z') {
+        c = (char)(c - 'a' + 'A');
+    }
+    if (c < ' ' || c > '_') {
+        return NULL;
+    }
+    return codes[c - ' '];
+}
+
+/*
+ *  ======== putSymbol ========
+ */
+static void putSymbol(uint8_t *bits, size_t index, unsigned symbol) {
+    if ((index & 3) == 0) {
+        bits[index >> 2] = 0;
+    }
+    bits[index >> 2] |= (uint8_t)(symbol << ((index & 3) * 2));
+}
+
+/*
+ *  ======== MorseCode_pack ========
+ *  Pack text into size bytes of bits. Characters without a Morse code,
+ *  like spaces, separate words. Returns the number of symbols, or 0 if
+ *  the text has no Morse characters or does not fit.
+ */
+size_t MorseCode_pack(const char *text, uint8_t *bits, size_t size) {
+    const char *code;
+    size_t count = 0;
+    unsigned gap = MorseCode_CHAR_GAP;  /* Owed before the next character */
+
+    for (; *text != '\0'; text++) {
+        code = MorseCode_lookup(*text);
+        if (code == NULL) {
+            gap = MorseCode_WORD_GAP;
+            continue;
+        }
+        if (count + strlen(code) + 2 > 4 * size) {
+            return 0;  /* Room for the character and the final word gap */
+        }
+        if (count != 0) {
+            putSymbol(bits, count++, gap);
+        }
+        gap = MorseCode_CHAR_GAP;
+        for (; *code != '\0'; code++) {
+            putSymbol(bits, count++, (*code == '.') ? MorseCode_DOT : MorseCode_DASH);
+        }
+    }
+    if (count != 0) {
+        putSymbol(bits, count++, MorseCode_WORD_GAP);
+    }
+    return count;
+}
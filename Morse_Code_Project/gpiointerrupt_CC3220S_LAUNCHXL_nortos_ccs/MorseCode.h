@@ -0,0 +1,50 @@
+/*
+ *  ======== MorseCode.h ========
+ *  Bit-packed Morse messages, played straight from their packed form.
+ *
+ *  A message is a stream of 2-bit symbols, four to a byte, first symbol
+ *  in the low bits:
+ *
+ *      MorseCode_DOT        dot, then the 1-unit gap inside a character
+ *      MorseCode_DASH       dash, then the 1-unit gap
+ *      MorseCode_CHAR_GAP   2 more units of gap: the 3-unit character gap
+ *      MorseCode_WORD_GAP   6 more units: the 7-unit word gap
+ *
+ *  Any run of spaces packs into one word gap, and every message ends with
+ *  one so it can be played in a loop. A symbol is found by shift and mask
+ *  at its index, so playback advances in constant time per element.
+ *
+ *  Constant messages are packed at build time by host/tools/morse_pack
+ *  into MorseMessages.h and stay in flash; MorseCode_pack() does the same
+ *  at run time. Dots light MorseCode_LED_DOT, dashes MorseCode_LED_DASH.
+ */
+
+#ifndef MorseCode_h
+#define MorseCode_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MorseCode_DOT        0
+#define MorseCode_DASH       1
+#define MorseCode_CHAR_GAP   2
+#define MorseCode_WORD_GAP   3
+
+#define MorseCode_LED_DOT    0x01  /* Red LED */
+#define MorseCode_LED_DASH   0x02  /* Green LED */
+
+/* Bytes to pack text of n characters; no character has more than 7 elements ('$'), plus its gap */
+#define MorseCode_PACKED_SIZE(n)  (2 * (n) + 1)
+
+#define MorseCode_symbol(bits, i)  (((bits)[(i) >> 2] >> (((i) & 3) * 2)) & 3)
+
+typedef struct {
+    const char    *text;
+    const uint8_t *bits;
+    uint16_t       symbols;
+} MorseCode_Message;
+
+extern const char *MorseCode_lookup(char c);
+extern size_t MorseCode_pack(const char *text, uint8_t *bits, size_t size);
+
+#endif /* MorseCode_h */
@@ -0,0 +1,28 @@
+/*
+ *  ======== MorseMessages.h ========
+ *  Morse messages packed by host/tools/morse_pack; regenerate rather than edit:
+ *
+ *      morse_pack "SOS" "OK" > MorseMessages.h
+ */
+
+#ifndef MorseMessages_h
+#define MorseMessages_h
+
+#include "MorseCode.h"
+
+/* "SOS": 12 symbols in 3 bytes */
+static const uint8_t MorseMessages_bits0[] = {
+    0x80, 0x95, 0xc0
+};
+
+/* "OK": 8 symbols in 2 bytes */
+static const uint8_t MorseMessages_bits1[] = {
+    0x95, 0xd1
+};
+
+static const MorseCode_Message MorseMessages_table[] = {
+    { "SOS", MorseMessages_bits0, 12 },
+    { "OK", MorseMessages_bits1, 8 },
+};
+
+#endif /* MorseMessages_h */
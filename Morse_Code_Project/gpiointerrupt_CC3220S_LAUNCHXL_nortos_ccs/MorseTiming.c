@@ -0,0 +1,44 @@
+/*
+ *  ======== MorseTiming.c ========
+ */
+
+#include "MorseCode.h"
+#include "MorseTiming.h"
+
+/*
+ *  ======== MorseTiming_init ========
+ *  Compute the periods for wpm, with Farnsworth spacing at effectiveWpm
+ *  if it is below wpm (0 = none). Returns false, leaving timing
+ *  unchanged, for a speed outside 1 to MorseTiming_MAX_WPM.
+ */
+bool MorseTiming_init(MorseTiming *timing, unsigned wpm, unsigned effectiveWpm) {
+    uint32_t unitUs, spaceUs, charGapUs, wordGapUs;
+
+    if (effectiveWpm == 0 || effectiveWpm > wpm) {
+        effectiveWpm = wpm;
+    }
+    if (wpm == 0 || wpm > MorseTiming_MAX_WPM) {
+        return false;
+    }
+
+    unitUs = 1200000u / wpm;
+    spaceUs = unitUs;
+    if (effectiveWpm < wpm) {
+        /* PARIS is 31 units of characters at wpm and 19 units of spacing */
+        spaceUs = (60000000u / effectiveWpm - 31u * unitUs) / 19u;
+    }
+    charGapUs = 3u * spaceUs - unitUs;
+    wordGapUs = 7u * spaceUs - unitUs;
+
+    timing->periods[2 * MorseCode_DOT] = unitUs * MorseTiming_COUNTS_PER_US;
+    timing->periods[2 * MorseCode_DOT + 1] = unitUs * MorseTiming_COUNTS_PER_US;
+    timing->periods[2 * MorseCode_DASH] = 3u * unitUs * MorseTiming_COUNTS_PER_US;
+    timing->periods[2 * MorseCode_DASH + 1] = unitUs * MorseTiming_COUNTS_PER_US;
+    timing->periods[2 * MorseCode_CHAR_GAP] = charGapUs / 2 * MorseTiming_COUNTS_PER_US;
+    timing->periods[2 * MorseCode_CHAR_GAP + 1] = (charGapUs - charGapUs / 2) * MorseTiming_COUNTS_PER_US;
+    timing->periods[2 * MorseCode_WORD_GAP] = wordGapUs / 2 * MorseTiming_COUNTS_PER_US;
+    timing->periods[2 * MorseCode_WORD_GAP + 1] = (wordGapUs - wordGapUs / 2) * MorseTiming_COUNTS_PER_US;
+    timing->wpm = (uint16_t)wpm;
+    timing->effectiveWpm = (uint16_t)effectiveWpm;
+    return true;
+}
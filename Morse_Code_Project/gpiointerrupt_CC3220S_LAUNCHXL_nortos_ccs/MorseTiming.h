@@ -0,0 +1,40 @@
+/*
+ *  ======== MorseTiming.h ========
+ *  Morse element timing for a speed in words per minute, as timer period
+ *  register values computed once per speed change.
+ *
+ *  Speeds follow the PARIS standard: a word is 50 units, so one unit (a
+ *  dot) lasts 1200 / wpm ms. A Farnsworth speed below wpm keeps the
+ *  characters at wpm but stretches the character and word gaps until
+ *  PARIS takes 60 / effectiveWpm s.
+ *
+ *  Every packed symbol (MorseCode.h) plays as two timer steps, and
+ *  periods[2 * symbol + step] is the length of each in timer counts:
+ *
+ *      dot        1 unit on, 1 unit off
+ *      dash       3 units on, 1 unit off
+ *      char gap   the 3-unit (Farnsworth: stretched) gap less the 1 unit
+ *                 already played, in two halves
+ *      word gap   likewise for the 7-unit gap
+ *
+ *  so playback is a table fetch per step whatever the speed.
+ */
+
+#ifndef MorseTiming_h
+#define MorseTiming_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MorseTiming_COUNTS_PER_US  80   /* Timer clock, 80 MHz */
+#define MorseTiming_MAX_WPM        100
+
+typedef struct {
+    uint32_t periods[8];    /* Timer counts by 2 * symbol + step */
+    uint16_t wpm;
+    uint16_t effectiveWpm;
+} MorseTiming;
+
+extern bool MorseTiming_init(MorseTiming *timing, unsigned wpm, unsigned effectiveWpm);
+
+#endif /* MorseTiming_h */
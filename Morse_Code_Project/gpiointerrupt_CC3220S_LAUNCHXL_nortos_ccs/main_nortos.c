@@ -40,6 +40,8 @@
 #include <NoRTOS.h>
 
 #include <ti/drivers/Board.h>
+#include <ti/devices/cc32xx/inc/hw_types.h>
+#include <ti/devices/cc32xx/driverlib/cpu.h>
 
 extern void *mainThread(void *arg0);
 
@@ -56,5 +58,8 @@ int main(void)
     /* Call mainThread function */
     mainThread(NULL);
 
-    while (1) {}
+    /* Nothing left to run; sleep instead of spinning */
+    while (1) {
+        CPUwfi();
+    }
 }
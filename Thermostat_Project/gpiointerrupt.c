@@ -46,38 +46,155 @@
 #include <ti/drivers/I2C.h>
 #include <ti/drivers/UART.h>
 #include <ti/drivers/GPIO.h>
+#include <ti/drivers/PWM.h>
+#include <ti/devices/cc32xx/driverlib/prcm.h>
 #include "ti_drivers_config.h"
+#include "LowPower.h"
+#include "Scheduler.h"
+#include "TempPipeline.h"
+#include "TempSensor.h"
+#include "TempConv.h"
+#include "TempFilter.h"
+#include "Pid.h"
+#include "Debounce.h"
+#include "EventQueue.h"
+#include "SensorCache.h"
+#include "BootProfile.h"
+#include "Telemetry.h"
+#include "TelemetryBatch.h"
+#include "UartTx.h"
+#include "Trace.h"
+#include "TraceEvents.h"
+
+/* Global Variables - owned by the main loop; interrupts reach it only through the EventQueue */
+unsigned int timeCounter = 0;  /* Seconds since reset */
+
+#define EVENT_BATCH         8  /* Events handled per EventQueue_take() */
+
+/* Debounce ids of the set-point buttons */
+#define BUTTON_DOWN         0  /* SW2 */
+#define BUTTON_UP           1  /* SW4 */
+
+/* Scheduler tick and task periods */
+#define TICK_MS             50
+#define TICKS_PER_SECOND    (1000 / TICK_MS)
+#define BUTTON_PERIOD_MS    50
+#define TEMP_PERIOD_MS      200
+#define HEATER_PERIOD_MS    500
+#define REPORT_PERIOD_MS    1000
+
+static void buttonTask(void);
+static void tempTask(void);
+static void heaterTask(void);
+static void reportTask(void);
+
+/* Task table, run in this order within a tick so data flows sensor -> heater -> report */
+static Scheduler_Task tasks[] = {
+    /* name     period            function    budget (us) */
+    { "button", BUTTON_PERIOD_MS, buttonTask, 20  },
+    { "temp",   TEMP_PERIOD_MS,   tempTask,   50  },
+    { "heater", HEATER_PERIOD_MS, heaterTask, 20  },
+    { "report", REPORT_PERIOD_MS, reportTask, 500 }
+};
 
-/* Global Variables */
-volatile int setPoint = 25;  /* Set-point temperature (default 25C) */
-volatile int roomTemperature = 0;  /* Room temperature */
-volatile unsigned int timeCounter = 0;  /* Seconds since reset */
-volatile unsigned char TimerFlag = 0;  /* Timer flag */
+/* Heater control: PI with a 60 s time-proportioning window, or the original on/off comparison */
+#ifndef HEATER_CONTROL_PID
+#define HEATER_CONTROL_PID  1
+#endif
+#define HEATER_KP           Pid_GAIN(2000)  /* Full duty at 0.5 degrees C below the set-point */
+#define HEATER_KI           Pid_GAIN(1)
+#define HEATER_KD           Pid_GAIN(0)
+#define HEATER_WINDOW       (60000 / HEATER_PERIOD_MS)
+
+/* Zones - each has its own sensor, set-point and heater output */
+#ifndef ZONE_COUNT
+#define ZONE_COUNT          1
+#endif
+#if ZONE_COUNT < 1 || ZONE_COUNT > 3 || ZONE_COUNT > TempPipeline_MAX_CHANNELS
+#error "ZONE_COUNT must be 1-3; add zoneConfigs[] rows for more"
+#endif
+#define DEFAULT_SET_POINT   25  /* Degrees C */
+#define PWM_PERIOD_US       1000
+
+/* PWM heater outputs need CONFIG_PWM_* instances. The LaunchPad's LED PWM pins (PIN_01, PIN_02) are
+   the I2C bus and its other PWM pins are JTAG, so this configuration has none and drives GPIOs. */
+#ifdef CONFIG_TI_DRIVERS_PWM_COUNT
+#define HEATER_PWM          1
+#else
+#define HEATER_PWM          0
+#endif
+
+/* Telemetry batching - records per UART write (changed at run time with '[' and ']') and longest wait */
+#ifndef TELEMETRY_BATCH_SIZE
+#define TELEMETRY_BATCH_SIZE    ZONE_COUNT  /* One write per report, whatever the zone count */
+#endif
+#ifndef TELEMETRY_FLUSH_MS
+#define TELEMETRY_FLUSH_MS      5000
+#endif
+
+typedef enum {
+    OUTPUT_GPIO,  /* On/off, time-proportioned over HEATER_WINDOW */
+    OUTPUT_PWM    /* Duty cycle straight from the controller; needs HEATER_PWM */
+} OutputKind;
+
+typedef struct {
+    uint8_t       sensorAddress;  /* 0 = the sensor detected at boot */
+    uint8_t       sensorDriver;   /* TempSensor_drivers[] index for a fixed address */
+    OutputKind    outputKind;
+    uint_least8_t output;         /* CONFIG_GPIO_* or CONFIG_PWM_* index */
+} ZoneConfig;
+
+/* The yellow and green LEDs share their pins with the I2C bus, so zones 1 and 2 drive heater GPIOs on free pins */
+static const ZoneConfig zoneConfigs[ZONE_COUNT] = {
+    { 0,    0,                 OUTPUT_GPIO, CONFIG_GPIO_LED_0 },     /* Red LED */
+#if ZONE_COUNT > 1
+    { 0x49, TempSensor_TMP116, OUTPUT_GPIO, CONFIG_GPIO_HEATER_1 },
+#endif
+#if ZONE_COUNT > 2
+    { 0x48, TempSensor_TMP11X, OUTPUT_GPIO, CONFIG_GPIO_HEATER_2 },
+#endif
+};
 
-/* UART and I2C Handles */
-UART_Handle uart;
+typedef struct {
+    const TempSensor_Driver *driver;
+    uint8_t       address;
+    int           setPoint;         /* Degrees C */
+    TempConv_Q7   temperature;      /* Filtered, 1/128 degree C */
+    bool          heaterOn;
+    TempFilter    filter;           /* Between the sensor and the heater decision */
+    Pid           pid;
+    Pid_Window    window;
+    PWM_Handle    pwm;
+} Zone;
+
+static Zone zones[ZONE_COUNT];
+static uint8_t selectedZone = 0;  /* Zone the buttons and '+'/'-' adjust */
+
+/* I2C Handle (UART output goes through the UartTx queue) */
 I2C_Handle i2c;
 
-/* I2C Configuration */
-static const struct {
-    uint8_t address;
-    uint8_t resultReg;
-    char *id;
-} sensors[3] = {
-    { 0x48, 0x0000, "11X" },
-    { 0x49, 0x0000, "116" },
-    { 0x41, 0x0001, "006" }
-};
+/* Receive buffer for the callback-mode UART read */
+static uint8_t uartRxByte;
+
+/* Trace drain in progress ('t'): next record to send and the head when it was asked for */
+static bool traceDraining = false;
+static uint32_t traceCursor;
+static uint32_t traceEnd;
+
+/* Sensor used when nothing answers the probe: TMP006, as the original firmware assumed */
+#define SENSOR_DEFAULT      TempSensor_TMP006
+
+/* SENSOR_FAST_BOOT, in SensorCache.h, boots with the sensor found last time, checked with one transfer */
 
 /*
  *  ======== timerCallback ========
  *  Timer callback function
- *  This function is called at each timer interrupt to update the state machine
- *  and control the LED blinking according to the Morse code pattern.
+ *  This function is called at each scheduler tick. It advances the
+ *  scheduler timebase and posts the tick to the main loop.
  */
 void timerCallback(Timer_Handle myHandle, int_fast16_t status) {
-    TimerFlag = 1;  /* Set timer flag */
-    timeCounter++;  /* Increment time counter */
+    Scheduler_tick();
+    EventQueue_post(EventQueue_TICK, 0, 0, 0);  /* Queued, so a late main loop still sees every tick */
 }
 
 /*
@@ -89,9 +206,8 @@ void initTimer(void) {
     Timer_Handle timer0;
     Timer_Params params;
 
-    Timer_init();
-    Timer_Params_init(&params);
-    params.period = 1000000;  /* 1 second period */
+    Timer_Params_init(&params);  /* Timer_init() was done by mainThread */
+    params.period = TICK_MS * 1000;  /* Scheduler tick period */
     params.periodUnits = Timer_PERIOD_US;
     params.timerMode = Timer_CONTINUOUS_CALLBACK;
     params.timerCallback = timerCallback;
@@ -101,41 +217,83 @@ void initTimer(void) {
         while (1) {}
     }
 
+    Scheduler_init(timer0, TICK_MS, tasks, sizeof(tasks) / sizeof(tasks[0]));
+
     if (Timer_start(timer0) == Timer_STATUS_ERROR) {
         while (1) {}
     }
 }
 
+/*
+ *  ======== uartReadCallback ========
+ *  UART read callback function
+ *  Posts each received byte to the main loop and waits for the next one.
+ */
+void uartReadCallback(UART_Handle handle, void *buf, size_t count) {
+    if (count == 1) {
+        Trace_log1(TraceEvents_UART_RX, uartRxByte);
+        EventQueue_post(EventQueue_UART_RX, uartRxByte, 0, 0);
+    }
+    UART_read(handle, &uartRxByte, 1);
+}
+
 /*
  *  ======== initUART ========
  *  Initialize UART for communication
+ *  Writes are queued by UartTx and sent in the background; received bytes
+ *  arrive as EventQueue_UART_RX events.
  */
 void initUART(void) {
     UART_Params uartParams;
+    UART_Handle uart;
 
     UART_init();
     UART_Params_init(&uartParams);
     uartParams.baudRate = 115200;
-
-    uart = UART_open(CONFIG_UART_0, &uartParams);
+    uartParams.writeDataMode = UART_DATA_BINARY;  /* Binary telemetry frames must pass unchanged */
+    uartParams.readMode = UART_MODE_CALLBACK;
+    uartParams.readCallback = uartReadCallback;
+    uartParams.readDataMode = UART_DATA_BINARY;
+    uartParams.readReturnMode = UART_RETURN_FULL;
+    uartParams.readEcho = UART_ECHO_OFF;
+
+    uart = UartTx_open(CONFIG_UART_0, &uartParams);  /* Non-blocking transmit queue */
     if (uart == NULL) {
         while (1) {}
     }
+    UART_read(uart, &uartRxByte, 1);  /* Start receiving commands */
+    TelemetryBatch_init(TELEMETRY_BATCH_SIZE, TELEMETRY_FLUSH_MS);
+}
+
+/*
+ *  ======== slowClockUs ========
+ *  Microseconds between two PRCM slow clock readings.
+ */
+static uint32_t slowClockUs(uint32_t start, uint32_t end) {
+    return (uint32_t)(((uint64_t)(end - start) * 1000000u) >> 15);
 }
 
 /*
  *  ======== initI2C ========
  *  Initialize I2C for temperature sensor
+ *  The sensor found on the last boot is tried first; all of them are
+ *  probed only if it does not answer, and the result is cached for the
+ *  next boot. Ends with one line giving the time each step took.
  */
 void initI2C(void) {
     int8_t i, found;
+    const TempSensor_Driver *driver;
+    TempPipeline_Channel channels[ZONE_COUNT];
+    uint32_t periodUs, zoneUs;
+    bool cached;  /* Found from the cache rather than by probing */
+    SensorCache_Entry entry;
+    uint32_t mark;
+    uint32_t loadUs = 0, verifyUs = 0, probeUs = 0, storeUs = 0;
     I2C_Params i2cParams;
-    I2C_Transaction i2cTransaction;
-    char output[64]; /* Buffer for output messages */
-    uint8_t txBuffer[1];
+    char output[128]; /* Buffer for output messages */
 
     snprintf(output, 64, "Initializing I2C Driver - ");
-    UART_write(uart, output, strlen(output));
+    UartTx_write(output, strlen(output));
 
     I2C_init();
     I2C_Params_init(&i2cParams);
@@ -144,74 +302,188 @@ void initI2C(void) {
     i2c = I2C_open(CONFIG_I2C_0, &i2cParams);
     if (i2c == NULL) {
         snprintf(output, 64, "Failed\n\r");
-        UART_write(uart, output, strlen(output));
+        UartTx_write(output, strlen(output));
         while (1);
     }
 
     snprintf(output, 64, "Passed\n\r");
-    UART_write(uart, output, strlen(output));
-
-    found = false;
-    for (i = 0; i < 3; ++i) {
-        i2cTransaction.slaveAddress = sensors[i].address;
-        txBuffer[0] = sensors[i].resultReg;
-        i2cTransaction.writeBuf = txBuffer;
-        i2cTransaction.writeCount = 1;
-        i2cTransaction.readBuf = NULL;
-        i2cTransaction.readCount = 0;
-
-        snprintf(output, 64, "Is this %s? ", sensors[i].id);
-        UART_write(uart, output, strlen(output));
-        if (I2C_transfer(i2c, &i2cTransaction)) {
-            snprintf(output, 64, "Found\n\r");
-            UART_write(uart, output, strlen(output));
-            found = true;
-            break;
+    UartTx_write(output, strlen(output));
+
+    found = -1;
+    cached = false;
+    mark = (uint32_t)PRCMSlowClkCtrFastGet();
+
+#if SENSOR_FAST_BOOT
+    if (SensorCache_load(&entry) && entry.index < TempSensor_DRIVER_COUNT &&
+        entry.address == TempSensor_drivers[entry.index]->address) {
+        loadUs = slowClockUs(mark, (uint32_t)PRCMSlowClkCtrFastGet());
+        mark = (uint32_t)PRCMSlowClkCtrFastGet();
+
+        driver = TempSensor_drivers[entry.index];
+        if (driver->verify(i2c, driver, entry.address)) {
+            found = entry.index;
+            cached = true;
         }
-        snprintf(output, 64, "No\n\r");
-        UART_write(uart, output, strlen(output));
+        verifyUs = slowClockUs(mark, (uint32_t)PRCMSlowClkCtrFastGet());
+    } else {
+        loadUs = slowClockUs(mark, (uint32_t)PRCMSlowClkCtrFastGet());
+    }
+    mark = (uint32_t)PRCMSlowClkCtrFastGet();
+#endif
+
+    if (found < 0) {  /* No cache, or the cached sensor did not answer: probe them all */
+        for (i = 0; i < TempSensor_DRIVER_COUNT; ++i) {
+            driver = TempSensor_drivers[i];
+            snprintf(output, 64, "Is this %s? ", driver->id);
+            UartTx_write(output, strlen(output));
+            if (driver->probe(i2c, driver, driver->address)) {
+                snprintf(output, 64, "Found\n\r");
+                UartTx_write(output, strlen(output));
+                found = i;
+                break;
+            }
+            snprintf(output, 64, "No\n\r");
+            UartTx_write(output, strlen(output));
+        }
+        probeUs = slowClockUs(mark, (uint32_t)PRCMSlowClkCtrFastGet());
+        mark = (uint32_t)PRCMSlowClkCtrFastGet();
+
+#if SENSOR_FAST_BOOT
+        if (found >= 0) {
+            entry.index = (uint8_t)found;
+            entry.address = TempSensor_drivers[found]->address;
+            SensorCache_store(&entry);
+            storeUs = slowClockUs(mark, (uint32_t)PRCMSlowClkCtrFastGet());
+        }
+#endif
     }
 
-    if (found) {
-        snprintf(output, 64, "Detected TMP Sensor\n\r");
-        UART_write(uart, output, strlen(output));
+    if (found >= 0) {
+        driver = TempSensor_drivers[found];
+        snprintf(output, sizeof(output), "Detected TMP%s at 0x%02x (%s): cache %lu us, verify %lu us, probe %lu us, store %lu us\n\r",
+                 driver->id, driver->address, cached ? "cached" : "probed",
+                 (unsigned long)loadUs, (unsigned long)verifyUs, (unsigned long)probeUs, (unsigned long)storeUs);
+        UartTx_write(output, strlen(output));
     } else {
         snprintf(output, 64, "Temperature sensor not found\n\r");
-        UART_write(uart, output, strlen(output));
+        UartTx_write(output, strlen(output));
+        driver = TempSensor_drivers[SENSOR_DEFAULT];
+    }
+
+    /* Zone 0 reads the detected sensor; the others have fixed sensors, checked once */
+    for (i = 0; i < ZONE_COUNT; i++) {
+        if (zoneConfigs[i].sensorAddress == 0) {
+            zones[i].driver = driver;
+            zones[i].address = driver->address;
+        } else {
+            zones[i].driver = TempSensor_drivers[zoneConfigs[i].sensorDriver];
+            zones[i].address = zoneConfigs[i].sensorAddress;
+            snprintf(output, 64, "Zone %d: TMP%s at 0x%02x %s\n\r", i, zones[i].driver->id, zones[i].address,
+                     zones[i].driver->verify(i2c, zones[i].driver, zones[i].address) ? "found" : "not found");
+            UartTx_write(output, strlen(output));
+        }
+        channels[i].driver = zones[i].driver;  /* Fixes the conversion used for every sample */
+        channels[i].address = zones[i].address;
+    }
+
+    /* Hand the bus over to the callback-mode sampling pipeline */
+    I2C_close(i2c);
+    i2c = NULL;
+    if (!TempPipeline_open(CONFIG_I2C_0, channels, ZONE_COUNT)) {
+        snprintf(output, 64, "Failed to start sensor pipeline\n\r");
+        UartTx_write(output, strlen(output));
+        while (1);
     }
+
+    /* Bus budget: one burst per sample period */
+    periodUs = TEMP_PERIOD_MS * 1000u;
+    zoneUs = TempPipeline_burstWireUs() / ZONE_COUNT;
+    snprintf(output, sizeof(output), "I2C burst for %d zone(s): %lu us at 400 kHz, %lu.%02lu%% of %d ms, room for %lu zones\n\r",
+             ZONE_COUNT, (unsigned long)TempPipeline_burstWireUs(),
+             (unsigned long)(TempPipeline_burstWireUs() * 100u / periodUs),
+             (unsigned long)(TempPipeline_burstWireUs() * 10000u / periodUs % 100u),
+             TEMP_PERIOD_MS, (unsigned long)(periodUs / zoneUs));
+    UartTx_write(output, strlen(output));
 }
 
 /*
- *  ======== readTemp ========
- *  Read temperature from the TMP006 sensor via I2C.
- *  Returns the temperature value in degrees Celsius.
+ *  ======== initZones ========
+ *  Set-points, filters, controllers and heater outputs of every zone.
+ *  Call after initI2C(), which assigns the sensors.
  */
-int16_t readTemp(void) {
-    int16_t temperature = 0;
-
-    I2C_Transaction i2cTransaction;
-    uint8_t txBuffer[1];
-    uint8_t rxBuffer[2];
-
-    i2cTransaction.slaveAddress = 0x41;  /* TMP006 I2C address */
-    txBuffer[0] = 0x01;  /* TMP006 register for temperature reading */
-    i2cTransaction.writeBuf = txBuffer;
-    i2cTransaction.writeCount = 1;
-    i2cTransaction.readBuf = rxBuffer;
-    i2cTransaction.readCount = 2;
-
-    if (I2C_transfer(i2c, &i2cTransaction)) {
-        temperature = (rxBuffer[0] << 8) | (rxBuffer[1]);
-        temperature *= 0.0078125;  /* Convert raw data to temperature value */
-
-        if (rxBuffer[0] & 0x80) {
-            temperature |= 0xF000;  /* Adjust for negative temperatures */
+void initZones(void) {
+#if HEATER_PWM
+    PWM_Params pwmParams;
+#endif
+    uint8_t i;
+
+#if HEATER_PWM
+    PWM_init();
+#endif
+    for (i = 0; i < ZONE_COUNT; i++) {
+        Zone *zone = &zones[i];
+
+        zone->setPoint = DEFAULT_SET_POINT;
+        zone->temperature = 0;
+        zone->heaterOn = false;
+        TempFilter_init(&zone->filter, TempFilter_DEFAULT_KIND);  /* Smooth samples before the heater decision */
+        Pid_init(&zone->pid, HEATER_KP, HEATER_KI, HEATER_KD, HEATER_PERIOD_MS);
+        Pid_windowInit(&zone->window, HEATER_WINDOW);
+        zone->pwm = NULL;
+
+        if (zoneConfigs[i].outputKind == OUTPUT_GPIO) {
+            GPIO_setConfig(zoneConfigs[i].output, GPIO_CFG_OUT_STD | GPIO_CFG_OUT_LOW);  /* Configure LED pin as output */
+        } else {
+#if HEATER_PWM
+            PWM_Params_init(&pwmParams);
+            pwmParams.periodUnits = PWM_PERIOD_US;
+            pwmParams.periodValue = PWM_PERIOD_US;
+            pwmParams.dutyUnits = PWM_DUTY_FRACTION;
+            pwmParams.dutyValue = 0;
+            zone->pwm = PWM_open(zoneConfigs[i].output, &pwmParams);
+            if (zone->pwm == NULL) {
+                while (1) {}
+            }
+            PWM_start(zone->pwm);
+#else
+            while (1) {}  /* No PWM instances in this configuration */
+#endif
         }
-    } else {
-        UART_write(uart, "Error reading temperature sensor\n\r", 34);
     }
+}
 
-    return temperature;
+/*
+ *  ======== readTemp ========
+ *  Read temperature from a zone's sensor via I2C.
+ *  Stores the temperature in 1/128 degrees Celsius (TempConv Q7) in the
+ *  zone the sensor event belongs to.
+ *
+ *  The value comes from the sensor event of a burst tempTask started, so
+ *  nothing waits on the bus. New samples pass through the zone's filter, so
+ *  the stored value is the filtered one.
+ */
+void readTemp(const EventQueue_Event *event) {
+    uint8_t channel;
+    int16_t raw;
+    Zone *zone;
+
+    switch (TempPipeline_result(event, &channel, &raw)) {
+        case TempPipeline_RESULT_NEW:
+            Trace_log2(TraceEvents_SENSOR, channel, (uint16_t)raw);
+            zone = &zones[channel];
+            zone->temperature = TempFilter_update(&zone->filter,
+                                                  TempSensor_convert(zone->driver, (uint16_t)raw));  /* No floating point */
+            break;
+        case TempPipeline_RESULT_ERROR:
+            Trace_log1(TraceEvents_SENSOR_ERROR, channel);
+            zone = &zones[channel];
+            zone->temperature = 0;
+            TempFilter_reset(&zone->filter);  /* Do not average across a sensor fault */
+            UartTx_write("Error reading temperature sensor\n\r", 34);
+            break;
+        case TempPipeline_RESULT_NONE:
+            break;
+    }
 }
 
 
@@ -219,64 +491,346 @@ int16_t readTemp(void) {
  *  ======== gpioButtonFxn0 ========
  *  GPIO button interrupt callback function.
  *  This function is triggered when SW2 is pressed and decreases the set-point temperature.
+ *  The press is debounced here and applied by buttonTask.
  */
 void gpioButtonFxn0(uint_least8_t index) {
-    setPoint--;  /* Decrease the set-point temperature by 1 degree */
+    if (Debounce_edge(BUTTON_DOWN)) {  /* Timestamp the edge and mask the bounce; buttonTask confirms it */
+        Trace_log1(TraceEvents_BUTTON, BUTTON_DOWN);
+    }
 }
 
 /*
  *  ======== gpioButtonFxn1 ========
  *  GPIO button interrupt callback function.
  *  This function is triggered when SW4 is pressed and increases the set-point temperature.
+ *  The press is debounced here and applied by buttonTask.
  */
 void gpioButtonFxn1(uint_least8_t index) {
-    setPoint++;  /* Increase the set-point temperature by 1 degree */
+    if (Debounce_edge(BUTTON_UP)) {  /* Timestamp the edge and mask the bounce; buttonTask confirms it */
+        Trace_log1(TraceEvents_BUTTON, BUTTON_UP);
+    }
 }
 
 
+/*
+ *  ======== buttonTask ========
+ *  Confirm debounced presses and apply them to the set-point. Holding a
+ *  button repeats the step, faster the longer it is held.
+ */
+static void buttonTask(void) {
+    int step;
+
+    Debounce_poll();
+    step = (int)Debounce_take(BUTTON_UP) - (int)Debounce_take(BUTTON_DOWN);  /* One degree per press */
+    if (step != 0) {
+        zones[selectedZone].setPoint += step;
+        Trace_log2(TraceEvents_SET_POINT, selectedZone, zones[selectedZone].setPoint);
+    }
+}
+
+/*
+ *  ======== tempTask ========
+ *  Start the next burst of sensor reads, one per zone; each result
+ *  arrives as a sensor event.
+ */
+static void tempTask(void) {
+    TempPipeline_trigger();
+}
+
+/*
+ *  ======== heaterTask ========
+ *  Drive each zone's heater output from its PI controller duty, or from a
+ *  plain temperature comparison when HEATER_CONTROL_PID is 0. GPIO outputs
+ *  time-proportion the duty over the window; PWM outputs take it directly.
+ */
+static void heaterTask(void) {
+    uint8_t i;
+    int32_t duty;
+    bool wasOn;
+
+    for (i = 0; i < ZONE_COUNT; i++) {
+        Zone *zone = &zones[i];
+
+        wasOn = zone->heaterOn;
+
+#if HEATER_CONTROL_PID
+        duty = Pid_update(&zone->pid, TempConv_fromDegrees(zone->setPoint), zone->temperature);
+#else
+        duty = (zone->temperature < TempConv_fromDegrees(zone->setPoint)) ? Pid_OUT_MAX : 0;
+#endif
+
+        if (zoneConfigs[i].outputKind == OUTPUT_PWM) {
+#if HEATER_PWM
+            PWM_setDuty(zone->pwm, (uint32_t)(((uint64_t)PWM_DUTY_FRACTION_MAX * (uint32_t)duty) / Pid_OUT_MAX));
+#endif
+            zone->heaterOn = duty > 0;
+        } else {
+            zone->heaterOn = Pid_windowStep(&zone->window, duty);
+            if (zone->heaterOn) {
+                GPIO_write(zoneConfigs[i].output, CONFIG_GPIO_LED_ON);  /* Turn ON LED (Heater ON) */
+            } else {
+                GPIO_write(zoneConfigs[i].output, CONFIG_GPIO_LED_OFF); /* Turn OFF LED (Heater OFF) */
+            }
+        }
+        if (zone->heaterOn != wasOn) {
+            Trace_log2(TraceEvents_HEATER, i, zone->heaterOn);
+        }
+    }
+}
+
+/*
+ *  ======== reportTask ========
+ *  Send data to UART - <RoomTemp,SetPoint,HeaterStatus,TimeCounter> or a binary frame,
+ *  one record per zone, through the batching stage.
+ */
+static void reportTask(void) {
+    Telemetry_Record record;
+    uint8_t i;
+
+    TelemetryBatch_poll(REPORT_PERIOD_MS);  /* Flush records that have waited long enough */
+    for (i = 0; i < ZONE_COUNT; i++) {
+        record.roomTemperature = zones[i].temperature;
+        record.setPoint = zones[i].setPoint;
+        record.heaterOn = zones[i].heaterOn;
+        record.timeCounter = timeCounter;
+        record.zone = i;
+        TelemetryBatch_add(&record);  /* Queued for UartTx once the batch is full */
+    }
+}
+
+
+/*
+ *  ======== handleCommand ========
+ *  Single-byte UART commands: '+' and '-' step the set-point of the
+ *  selected zone, '0'-'9' select the zone, 'a', 'b' and 'd' select ASCII,
+ *  binary or delta-compressed telemetry, 'i' reports the measured I2C burst statistics,
+ *  '[' and ']' shrink and grow the telemetry batch, 's' reports what
+ *  batching has saved, 't' sends the trace buffer (see traceDrain), 'p'
+ *  reports the time awake against the time asleep in WFI, 'q' reports the
+ *  drops and high-water marks of the UART transmit and event queues, 'c'
+ *  reports what each task costs, 'k' reports the button interrupts against
+ *  the presses.
+ *  Anything else is ignored.
+ */
+static void handleCommand(uint8_t command) {
+    TempPipeline_Stats i2cStats;
+    TelemetryBatch_Stats batchStats;
+    LowPower_Stats powerStats;
+    UartTx_Stats txStats;
+    EventQueue_Stats eventStats;
+    Scheduler_Stats schedulerStats;
+    Scheduler_TaskStats taskStats;
+    Debounce_Stats buttonStats;
+    uint_least8_t task, button;
+    uint32_t duty;
+    char output[192];
+
+    if (command >= '0' && command < '0' + ZONE_COUNT) {
+        selectedZone = command - '0';
+        return;
+    }
+    switch (command) {
+        case '+':
+        case '-':
+            zones[selectedZone].setPoint += (command == '+') ? 1 : -1;
+            Trace_log2(TraceEvents_SET_POINT, selectedZone, zones[selectedZone].setPoint);
+            break;
+        case 'a':
+        case 'b':
+        case 'd':
+            Telemetry_setMode(command == 'a' ? Telemetry_MODE_ASCII :
+                              command == 'b' ? Telemetry_MODE_BINARY : Telemetry_MODE_DELTA);
+            Trace_log1(TraceEvents_MODE, Telemetry_getMode());
+            break;
+        case 'i':
+            TempPipeline_getStats(&i2cStats);
+            snprintf(output, sizeof(output), "I2C bursts %lu, busy %lu, failed %lu of %lu, longest %lu us\n\r",
+                     (unsigned long)i2cStats.bursts, (unsigned long)i2cStats.busy, (unsigned long)i2cStats.failed,
+                     (unsigned long)i2cStats.started, (unsigned long)i2cStats.maxBurstUs);
+            UartTx_write(output, strlen(output));
+            break;
+        case '[': TelemetryBatch_setSize(TelemetryBatch_getSize() - 1); break;
+        case ']': TelemetryBatch_setSize(TelemetryBatch_getSize() + 1); break;
+        case 's':
+            TelemetryBatch_flush();  /* Keep the report after the records it counts */
+            TelemetryBatch_getStats(&batchStats);
+            snprintf(output, sizeof(output), "Batch %u: %lu records in %lu writes, %lu calls and %lu bytes saved, %lu dropped\n\r",
+                     (unsigned)TelemetryBatch_getSize(), (unsigned long)batchStats.records,
+                     (unsigned long)batchStats.flushes, (unsigned long)batchStats.callsSaved,
+                     (unsigned long)batchStats.bytesSaved, (unsigned long)batchStats.dropped);
+            UartTx_write(output, strlen(output));
+            break;
+        case 't':
+            traceEnd = Trace_buffer.head;
+            traceCursor = traceEnd > Trace_CAPACITY ? traceEnd - Trace_CAPACITY : 0;
+            traceDraining = true;
+            break;
+        case 'p':
+            duty = LowPower_dutyPermille();
+            LowPower_getStats(&powerStats);
+            snprintf(output, sizeof(output), "Awake %lu.%lu%%: %lu sleeps, active %lu us, idle %lu ms\n\r",
+                     (unsigned long)(duty / 10), (unsigned long)(duty % 10), (unsigned long)powerStats.sleeps,
+                     (unsigned long)(powerStats.activeTicks * 1000000 / LowPower_TICKS_PER_SEC),
+                     (unsigned long)(powerStats.idleTicks * 1000 / LowPower_TICKS_PER_SEC));
+            UartTx_write(output, strlen(output));
+            break;
+        case 'c':
+            Scheduler_getStats(&schedulerStats);
+            snprintf(output, sizeof(output), "Scheduler %lu ticks, %lu late, %lu passes\n\r",
+                     (unsigned long)schedulerStats.ticks, (unsigned long)schedulerStats.lateTicks,
+                     (unsigned long)schedulerStats.passes);
+            UartTx_write(output, strlen(output));
+            for (task = 0; Scheduler_getTaskStats(task, &taskStats); task++) {
+                snprintf(output, sizeof(output), "  %-6s %lu runs, mean %lu us, max %lu us, %lu over %lu us, %lu overruns\n\r",
+                         tasks[task].name, (unsigned long)taskStats.runs,
+                         (unsigned long)(taskStats.runs ? taskStats.totalCounts / taskStats.runs / Scheduler_COUNTS_PER_US : 0),
+                         (unsigned long)(taskStats.maxCounts / Scheduler_COUNTS_PER_US), (unsigned long)taskStats.overBudget,
+                         (unsigned long)tasks[task].budgetUs, (unsigned long)taskStats.overruns);
+                UartTx_write(output, strlen(output));
+            }
+            break;
+        case 'k':
+            for (button = 0; Debounce_getStats(button, &buttonStats); button++) {
+                snprintf(output, sizeof(output), "Button %u: %lu interrupts, at least %lu bounce masked, %lu presses, %lu repeats, %lu rejected\n\r",
+                         (unsigned)button, (unsigned long)buttonStats.interrupts, (unsigned long)buttonStats.suppressed,
+                         (unsigned long)buttonStats.presses, (unsigned long)buttonStats.repeats,
+                         (unsigned long)buttonStats.rejected);
+                UartTx_write(output, strlen(output));
+            }
+            break;
+        case 'q':
+            UartTx_getStats(&txStats);
+            snprintf(output, sizeof(output), "UART tx %lu writes, %lu bytes in %lu chunks, high water %u of %u, %lu dropped (%lu bytes)\n\r",
+                     (unsigned long)txStats.writes, (unsigned long)txStats.bytes, (unsigned long)txStats.chunks,
+                     (unsigned)txStats.highWater, (unsigned)(UartTx_BUFFER_SIZE - 1),
+                     (unsigned long)txStats.dropped, (unsigned long)txStats.droppedBytes);
+            UartTx_write(output, strlen(output));
+            EventQueue_getStats(&eventStats);
+            snprintf(output, sizeof(output), "Events %lu tick, %lu button, %lu sensor, %lu rx; overruns %lu/%lu/%lu/%lu; "
+                     "%lu batches, largest %u, high water %u of %u\n\r",
+                     (unsigned long)eventStats.posted[EventQueue_TICK], (unsigned long)eventStats.posted[EventQueue_BUTTON],
+                     (unsigned long)eventStats.posted[EventQueue_SENSOR], (unsigned long)eventStats.posted[EventQueue_UART_RX],
+                     (unsigned long)eventStats.overruns[EventQueue_TICK], (unsigned long)eventStats.overruns[EventQueue_BUTTON],
+                     (unsigned long)eventStats.overruns[EventQueue_SENSOR], (unsigned long)eventStats.overruns[EventQueue_UART_RX],
+                     (unsigned long)eventStats.batches, (unsigned)eventStats.maxBatch, (unsigned)eventStats.highWater,
+                     (unsigned)EventQueue_SIZE);
+            UartTx_write(output, strlen(output));
+            break;
+        default: break;
+    }
+}
+
+/*
+ *  ======== traceDrain ========
+ *  Send the trace records that were in the buffer when 't' arrived, one
+ *  "!t," line per record, for host/tools/trace_decode. Only as many lines
+ *  as UartTx has room for go out per call, so the drain never drops
+ *  telemetry or holds up the main loop; the rest follow on later passes
+ *  of the loop. Records overwritten before they are sent show up as a
+ *  sequence gap in the decoder.
+ */
+static void traceDrain(void) {
+    Trace_Record record;
+    char line[Trace_LINE_LEN];
+    uint32_t lost = 0;
+
+    while (traceDraining && UartTx_BUFFER_SIZE - 1 - UartTx_pending() >= 2 * Trace_LINE_LEN) {
+        if ((int32_t)(traceEnd - traceCursor) <= 0 || Trace_read(&traceCursor, &record, 1, &lost) == 0) {
+            traceDraining = false;
+            break;
+        }
+        UartTx_write(line, Trace_formatLine(&record, line));
+    }
+}
+
+/*
+ *  ======== handleEvents ========
+ *  Drain the event queue in batches and run the tasks the ticks released.
+ */
+static void handleEvents(void) {
+    static uint8_t secondTicks = 0;
+    EventQueue_Event events[EVENT_BATCH];
+    size_t count, i;
+    uint32_t ticks;
+
+    while ((count = EventQueue_take(events, EVENT_BATCH)) != 0) {
+        ticks = 0;
+        for (i = 0; i < count; i++) {
+            switch (events[i].type) {
+                case EventQueue_TICK:
+                    ticks++;
+                    if (++secondTicks == TICKS_PER_SECOND) {
+                        secondTicks = 0;
+                        timeCounter++;  /* Increment time counter */
+                    }
+                    break;
+                case EventQueue_BUTTON:
+                    Debounce_handleEdge(events[i].arg, events[i].time);
+                    break;
+                case EventQueue_SENSOR:
+                    readTemp(&events[i]);
+                    break;
+                case EventQueue_UART_RX:
+                    handleCommand(events[i].arg);
+                    break;
+            }
+        }
+        Scheduler_run(ticks);  /* Button 50 ms, temperature 200 ms, heater 500 ms, report 1 s */
+    }
+}
+
 /*
  *  ======== mainThread ========
  *  Main function where the program execution begins.
  *  Initializes all peripherals and enters the main loop to execute thermostat logic.
  */
 void *mainThread(void *arg0) {
+    Debounce_Params debounceParams;
+    char bootRecord[160];
+
+    BootProfile_start();  /* Time each init stage from here */
+    Trace_init();  /* Before any interrupt can log */
+    EventQueue_init();  /* Before any interrupt can post */
     GPIO_init();  /* Initialize GPIO */
+    BootProfile_mark("gpio");
     Timer_init();  /* Initialize Timer */
+    BootProfile_mark("timer");
     initUART();  /* Initialize UART for data communication */
-    initI2C();   /* Initialize I2C for temperature sensor */
-    initTimer(); /* Initialize Timer for 1-second intervals */
-
-    /* Configure GPIO pins */
-    GPIO_setConfig(CONFIG_GPIO_LED_0, GPIO_CFG_OUT_STD | GPIO_CFG_OUT_LOW);  /* Configure LED pin as output */
+    BootProfile_mark("uart");
+    initI2C();   /* Initialize I2C for the zone temperature sensors */
+    BootProfile_mark("i2c");
+    initZones(); /* Set-points, filters, controllers and heater outputs */
+    BootProfile_mark("zones");
+    initTimer(); /* Initialize Timer for the 50 ms scheduler tick */
+    BootProfile_mark("tick");
+
+    /* Configure GPIO pins (heater outputs were set up by initZones) */
     GPIO_setConfig(CONFIG_GPIO_BUTTON_0, GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_FALLING);  /* Configure SW2 as input with pull-up resistor */
     GPIO_setConfig(CONFIG_GPIO_BUTTON_1, GPIO_CFG_IN_PU | GPIO_CFG_IN_INT_FALLING);  /* Configure SW4 as input with pull-up resistor */
 
+    /* Debounce both buttons, with hold-to-repeat */
+    Debounce_Params_init(&debounceParams);
+    Debounce_open(BUTTON_DOWN, CONFIG_GPIO_BUTTON_0, &debounceParams);
+    Debounce_open(BUTTON_UP, CONFIG_GPIO_BUTTON_1, &debounceParams);
+
     /* Enable button interrupts */
     GPIO_setCallback(CONFIG_GPIO_BUTTON_0, gpioButtonFxn0);  /* Set SW2 callback function */
     GPIO_enableInt(CONFIG_GPIO_BUTTON_0);  /* Enable interrupts for SW2 */
     GPIO_setCallback(CONFIG_GPIO_BUTTON_1, gpioButtonFxn1);  /* Set SW4 callback function */
     GPIO_enableInt(CONFIG_GPIO_BUTTON_1);  /* Enable interrupts for SW4 */
 
-    /* Main loop - Executes every 1 second based on TimerFlag */
-    while (1) {
-        if (TimerFlag) {
-            TimerFlag = 0;  /* Clear TimerFlag */
+    BootProfile_mark("buttons");
 
-            /* Read temperature from the TMP006 sensor */
-            roomTemperature = readTemp();
+    LowPower_init();  /* Start measuring active versus idle time */
 
-            /* Control LED based on temperature comparison */
-            if (roomTemperature < setPoint) {
-                GPIO_write(CONFIG_GPIO_LED_0, CONFIG_GPIO_LED_ON);  /* Turn ON LED (Heater ON) */
-            } else {
-                GPIO_write(CONFIG_GPIO_LED_0, CONFIG_GPIO_LED_OFF); /* Turn OFF LED (Heater OFF) */
-            }
+    /* One boot timeline record per start-up */
+    UartTx_write(bootRecord, BootProfile_format(bootRecord, sizeof(bootRecord)));
+    Trace_log1(TraceEvents_BOOT, BootProfile_totalUs());
 
-            /* Send data to UART - Format: <RoomTemp,SetPoint,HeaterStatus,TimeCounter> */
-            char output[64];
-            snprintf(output, sizeof(output), "<%02d,%02d,%d,%04d>\n",
-                     roomTemperature, setPoint, GPIO_read(CONFIG_GPIO_LED_0), timeCounter);
-            UART_write(uart, output, strlen(output));  /* Transmit data via UART */
-        }
+    /* Main loop - Sleeps until an interrupt posts an event, then handles the batch */
+    while (1) {
+        LowPower_idle(EventQueue_pending);  /* Sleep until the timer, a button, I2C or the UART posts */
+        handleEvents();
+        traceDrain();  /* Trace lines go out as UartTx drains */
     }
 }
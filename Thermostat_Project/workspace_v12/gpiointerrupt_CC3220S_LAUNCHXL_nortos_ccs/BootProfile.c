@@ -0,0 +1,125 @@
+/*
+ *  ======== BootProfile.c ========
+ *  Marks are only taken while booting, from the main thread, so they need
+ *  no locking. The 32-bit counter wraps after 53 s at 80 MHz, far longer
+ *  than any boot.
+ */
+
+#include <stdio.h>
+
+#include "BootProfile.h"
+#include "CycleCounter.h"
+
+#if CycleCounter_DWT
+
+/*
+ *  ======== counterStart ========
+ */
+static void counterStart(void) {
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNT;
+}
+
+/*
+ *  ======== counterRead ========
+ */
+static uint32_t counterRead(void) {
+    return DWT_CYCCNT;
+}
+
+#else  /* Host build */
+
+#include <time.h>
+
+static uint64_t originNs;
+
+/*
+ *  ======== monoNs ========
+ */
+static uint64_t monoNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void counterStart(void) {
+    originNs = monoNs();
+}
+
+static uint32_t counterRead(void) {
+    return (uint32_t)((monoNs() - originNs) * BootProfile_COUNTS_PER_US / 1000u);
+}
+
+#endif
+
+static struct {
+    const char *stage;
+    uint32_t    counts;  /* Counter value at the end of the stage */
+} marks[BootProfile_MAX_MARKS];
+static uint_least8_t markCount;
+
+/*
+ *  ======== BootProfile_start ========
+ */
+void BootProfile_start(void) {
+    markCount = 0;
+    counterStart();
+}
+
+/*
+ *  ======== BootProfile_mark ========
+ *  Ends the stage named; marks beyond BootProfile_MAX_MARKS are dropped.
+ */
+void BootProfile_mark(const char *stage) {
+    uint32_t now = counterRead();
+
+    if (markCount < BootProfile_MAX_MARKS) {
+        marks[markCount].stage = stage;
+        marks[markCount].counts = now;
+        markCount++;
+    }
+}
+
+/*
+ *  ======== BootProfile_totalUs ========
+ *  Time from BootProfile_start() to the last mark.
+ */
+uint32_t BootProfile_totalUs(void) {
+    return (markCount == 0) ? 0 : marks[markCount - 1].counts / BootProfile_COUNTS_PER_US;
+}
+
+/*
+ *  ======== BootProfile_format ========
+ *  Writes the record, ending "\n\r" like the other console lines, and
+ *  returns its length. A record that does not fit is cut at a stage.
+ */
+size_t BootProfile_format(char *buffer, size_t size) {
+    uint32_t previous = 0;
+    size_t length;
+    int n;
+    uint_least8_t i;
+
+    n = snprintf(buffer, size, "!boot,%s,%lu", BootProfile_BUILD_ID,
+                 (unsigned long)BootProfile_totalUs());
+    if (n < 0 || (size_t)n + 2 >= size) {
+        return 0;
+    }
+    length = (size_t)n;
+
+    for (i = 0; i < markCount; i++) {
+        n = snprintf(buffer + length, size - length, ",%s=%lu", marks[i].stage,
+                     (unsigned long)((marks[i].counts - previous) / BootProfile_COUNTS_PER_US));
+        if (n < 0 || length + (size_t)n + 2 >= size) {
+            buffer[length] = '\0';
+            break;
+        }
+        length += (size_t)n;
+        previous = marks[i].counts;
+    }
+    buffer[length++] = '\n';
+    buffer[length++] = '\r';
+    buffer[length] = '\0';
+    return length;
+}
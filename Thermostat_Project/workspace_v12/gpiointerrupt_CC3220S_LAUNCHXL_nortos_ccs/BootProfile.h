@@ -0,0 +1,41 @@
+/*
+ *  ======== BootProfile.h ========
+ *  Boot and init timeline on a free-running cycle counter.
+ *
+ *  BootProfile_start() zeroes the counter at the top of mainThread and each
+ *  BootProfile_mark() records the end of one init stage. Once startup is
+ *  done, BootProfile_format() renders the whole timeline as one line:
+ *
+ *    !boot,<build>,<total us>,<stage>=<us>,...
+ *
+ *  where each stage time is the time since the previous mark. The leading
+ *  '!' keeps the record apart from the "<...>" telemetry lines.
+ *
+ *  The counter is the Cortex-M4 DWT CYCCNT on the target. Host builds use
+ *  clock_gettime(CLOCK_MONOTONIC) scaled to the same 80 MHz counts; that
+ *  is host wall time, not the HostSim virtual clock.
+ */
+
+#ifndef BootProfile_h
+#define BootProfile_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef BootProfile_MAX_MARKS
+#define BootProfile_MAX_MARKS  12
+#endif
+
+/* Identifies the build in the record; override with -DBootProfile_BUILD_ID=\"...\" */
+#ifndef BootProfile_BUILD_ID
+#define BootProfile_BUILD_ID   __DATE__ " " __TIME__
+#endif
+
+#define BootProfile_COUNTS_PER_US  80
+
+extern void BootProfile_start(void);
+extern void BootProfile_mark(const char *stage);
+extern uint32_t BootProfile_totalUs(void);
+extern size_t BootProfile_format(char *buffer, size_t size);
+
+#endif /* BootProfile_h */
@@ -0,0 +1,59 @@
+/*
+ *  ======== Debounce.h ========
+ *  Button debounce with edge timestamps and hold-to-repeat.
+ *
+ *  The button's GPIO callback calls Debounce_edge(), which masks the pin
+ *  interrupt, so the contact bounce that follows never reaches the CPU,
+ *  and posts an EventQueue_BUTTON event timestamped on the PRCM slow clock.
+ *  The main loop hands that event to Debounce_handleEdge(). Debounce_poll(),
+ *  called from a periodic tick, confirms the press once the contact has
+ *  settled, generates repeats while the button is held, and unmasks the
+ *  interrupt after a settled release. Debounce_take() hands the confirmed
+ *  presses to the application. Everything but Debounce_edge() runs in the
+ *  main loop.
+ */
+
+#ifndef Debounce_h
+#define Debounce_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef Debounce_MAX_BUTTONS
+#define Debounce_MAX_BUTTONS  2
+#endif
+
+typedef struct {
+    uint16_t settleMs;       /* Contact must read pressed this long after the edge */
+    uint16_t trustAfterMs;   /* Polls later than this accept the edge alone; 0 = never */
+    uint16_t repeatDelayMs;  /* Hold time before the first repeat; 0 = no repeat */
+    uint16_t repeatStartMs;  /* First repeat interval */
+    uint16_t repeatMinMs;    /* Each repeat interval is 3/4 of the last, down to this */
+} Debounce_Params;
+
+/*
+ *  interrupts against presses is what masking saves: one interrupt per
+ *  press, however much the contact bounces. suppressed is only a lower
+ *  bound on the bounce edges masked. Masked edges never reach software,
+ *  and the GPIO driver has no raw interrupt status to read, so the count is
+ *  the bounce the poll happens to see on the contact while the interrupt is
+ *  masked; bounce between two polls goes uncounted.
+ */
+typedef struct {
+    uint32_t interrupts;  /* Edge interrupts taken */
+    uint32_t suppressed;  /* Bounce seen by the poll while the interrupt was masked; a lower bound */
+    uint32_t leaked;      /* Edge events for a button that was already armed */
+    uint32_t rejected;    /* Edges that did not settle into a press */
+    uint32_t presses;     /* Confirmed presses */
+    uint32_t repeats;     /* Repeats generated while held */
+} Debounce_Stats;
+
+extern void Debounce_Params_init(Debounce_Params *params);
+extern bool Debounce_open(uint_least8_t id, uint_least8_t gpioIndex, const Debounce_Params *params);
+extern bool Debounce_edge(uint_least8_t id);
+extern void Debounce_handleEdge(uint_least8_t id, uint32_t time);
+extern void Debounce_poll(void);
+extern uint32_t Debounce_take(uint_least8_t id);
+extern bool Debounce_getStats(uint_least8_t id, Debounce_Stats *stats);
+
+#endif /* Debounce_h */
@@ -0,0 +1,29 @@
+/*
+ *  ======== LowPower.h ========
+ *  Sleep-until-interrupt idle for the NoRTOS main loops, with duty cycle
+ *  accounting on the 32.768 kHz PRCM slow clock counter.
+ */
+
+#ifndef LowPower_h
+#define LowPower_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LowPower_TICKS_PER_SEC  32768u  /* PRCM slow clock */
+
+/* Returns true when the main loop has work; checked with interrupts masked */
+typedef bool (*LowPower_PendingFxn)(void);
+
+typedef struct {
+    uint32_t sleeps;       /* Number of WFI entries */
+    uint64_t idleTicks;    /* Slow clock ticks spent in WFI */
+    uint64_t activeTicks;  /* Slow clock ticks spent awake */
+} LowPower_Stats;
+
+extern void LowPower_init(void);
+extern void LowPower_idle(LowPower_PendingFxn pending);
+extern void LowPower_getStats(LowPower_Stats *stats);
+extern uint32_t LowPower_dutyPermille(void);
+
+#endif /* LowPower_h */
@@ -0,0 +1,100 @@
+/*
+ *  ======== Pid.c ========
+ *  Integer PID with clamped, conditional integration.
+ *
+ *  Products are formed in 64 bits (one SMULL on the Cortex-M4) and shifted
+ *  back to permille, so no gain or error combination can overflow. The
+ *  integral is held between 0 and full duty, and it stops growing while the
+ *  output is saturated in the direction the error pushes. That keeps a long
+ *  warm-up from winding the integral far past what the room needs.
+ */
+
+#include "Pid.h"
+
+/*
+ *  ======== clamp ========
+ */
+static int64_t clamp(int64_t value, int64_t low, int64_t high) {
+    return (value < low) ? low : (value > high) ? high : value;
+}
+
+/*
+ *  ======== Pid_init ========
+ *  Gains come from Pid_GAIN(); tickMs is the interval between updates.
+ */
+void Pid_init(Pid *pid, int32_t kp, int32_t ki, int32_t kd, uint32_t tickMs) {
+    pid->kp = kp;
+    pid->kiTick = (int32_t)(((int64_t)ki * tickMs + 500) / 1000);
+    pid->kdTick = (int32_t)(((int64_t)kd * 1000 + tickMs / 2) / tickMs);
+    Pid_reset(pid);
+}
+
+/*
+ *  ======== Pid_reset ========
+ *  Clear the integral and derivative history, e.g. after a sensor fault.
+ */
+void Pid_reset(Pid *pid) {
+    pid->integral = 0;
+    pid->last = 0;
+    pid->primed = false;
+}
+
+/*
+ *  ======== Pid_update ========
+ *  One control step; returns the heater duty, 0 to Pid_OUT_MAX permille.
+ */
+int32_t Pid_update(Pid *pid, TempConv_Q7 setPoint, TempConv_Q7 measurement) {
+    const int64_t outMax = (int64_t)Pid_OUT_MAX << Pid_SHIFT;
+    int32_t error = setPoint - measurement;
+    int64_t integral;
+    int64_t sum;
+
+    if (!pid->primed) {
+        pid->last = measurement;
+        pid->primed = true;
+    }
+
+    integral = clamp(pid->integral + (int64_t)pid->kiTick * error, 0, outMax);
+    sum = (int64_t)pid->kp * error
+        + integral
+        - (int64_t)pid->kdTick * (measurement - pid->last);
+
+    /* Anti-windup: do not integrate further into a saturated output */
+    if ((sum > outMax && error > 0) || (sum < 0 && error < 0)) {
+        integral = pid->integral;
+    }
+    pid->integral = (int32_t)integral;
+    pid->last = measurement;
+
+    return (int32_t)(clamp(sum, 0, outMax) >> Pid_SHIFT);
+}
+
+/*
+ *  ======== Pid_windowInit ========
+ *  length is the window in control ticks; it bounds the switching rate to
+ *  two changes per window and sets the duty resolution to 1/length.
+ */
+void Pid_windowInit(Pid_Window *window, uint16_t length) {
+    window->length = length;
+    window->phase = 0;
+    window->onTicks = 0;
+}
+
+/*
+ *  ======== Pid_windowStep ========
+ *  Advance one tick; returns whether the heater is on for it. The duty is
+ *  sampled only at the start of a window so one window is one on/off cycle.
+ */
+bool Pid_windowStep(Pid_Window *window, int32_t duty) {
+    bool on;
+
+    if (window->phase == 0) {
+        window->onTicks = (uint16_t)((duty * window->length + Pid_OUT_MAX / 2) / Pid_OUT_MAX);
+    }
+    on = window->phase < window->onTicks;
+
+    if (++window->phase >= window->length) {
+        window->phase = 0;
+    }
+    return on;
+}
@@ -0,0 +1,50 @@
+/*
+ *  ======== Pid.h ========
+ *  Fixed-point PID controller for the heater, with anti-windup, and a
+ *  time-proportioning output that turns its duty into on/off switching.
+ *
+ *  The controller runs once per control tick on TempConv_Q7 temperatures
+ *  and returns a heater duty in permille. Gains are Q8 fixed point; use
+ *  Pid_GAIN() so the conversion happens at compile time:
+ *    kp  permille per degree C of error
+ *    ki  permille per degree C per second of accumulated error
+ *    kd  permille per degree C per second of temperature change
+ *  The derivative acts on the measurement, so set-point changes do not kick.
+ */
+
+#ifndef Pid_h
+#define Pid_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "TempConv.h"
+
+#define Pid_GAIN(x)      ((int32_t)((x) * 256))
+#define Pid_SHIFT        15    /* Q8 gain times Q7 error */
+#define Pid_OUT_MAX      1000  /* Full heater duty, permille */
+
+typedef struct {
+    int32_t     kp;
+    int32_t     kiTick;      /* ki scaled to one tick */
+    int32_t     kdTick;      /* kd scaled to one tick */
+    int32_t     integral;    /* Integral term, permille << Pid_SHIFT */
+    TempConv_Q7 last;        /* Previous measurement */
+    bool        primed;      /* last is valid */
+} Pid;
+
+/* Time-proportioning window: the duty becomes one on period per window */
+typedef struct {
+    uint16_t length;   /* Ticks per window */
+    uint16_t phase;    /* Tick within the window */
+    uint16_t onTicks;  /* On time for the current window, latched at its start */
+} Pid_Window;
+
+extern void Pid_init(Pid *pid, int32_t kp, int32_t ki, int32_t kd, uint32_t tickMs);
+extern void Pid_reset(Pid *pid);
+extern int32_t Pid_update(Pid *pid, TempConv_Q7 setPoint, TempConv_Q7 measurement);
+
+extern void Pid_windowInit(Pid_Window *window, uint16_t length);
+extern bool Pid_windowStep(Pid_Window *window, int32_t duty);
+
+#endif /* Pid_h */
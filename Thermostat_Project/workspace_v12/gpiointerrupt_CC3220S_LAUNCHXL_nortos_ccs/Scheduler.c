@@ -0,0 +1,145 @@
+/*
+ *  ======== Scheduler.c ========
+ *  Table-driven multi-rate scheduler.
+ *
+ *  The tick interrupt only advances the timebase; the ticks themselves
+ *  reach Scheduler_run() as events. Each pass advances every task by the
+ *  ticks it was given. A task that became due more than once in that span
+ *  runs once and the extra releases are counted as overruns, so a slow task
+ *  shows up in its own statistics and in those of the tasks it held up.
+ *
+ *  Task cost is measured with Timer_getCount() on the tick timer, combined
+ *  with the tick count so that runs longer than one tick are still timed.
+ */
+
+#include <stddef.h>
+
+#include <ti/drivers/Timer.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "Scheduler.h"
+
+static Timer_Handle timer;
+static uint32_t tickMs;
+static uint32_t periodCounts;
+static Scheduler_Task *tasks;
+static uint_least8_t taskCount;
+
+static volatile uint32_t tickCount;  /* Written only by Scheduler_tick() */
+
+static Scheduler_Stats stats;
+
+/*
+ *  ======== nowCounts ========
+ *  Timer counts since Scheduler_init(). Retries if a tick lands between
+ *  reading the tick count and the timer.
+ */
+static uint64_t nowCounts(void) {
+    uint32_t ticks;
+    uint32_t count;
+
+    do {
+        ticks = tickCount;
+        count = Timer_getCount(timer);
+    } while (ticks != tickCount);
+
+    return (uint64_t)ticks * periodCounts + count;
+}
+
+/*
+ *  ======== Scheduler_init ========
+ *  The timer must be open with a period of tickMs and not yet started.
+ */
+void Scheduler_init(Timer_Handle handle, uint32_t period, Scheduler_Task *table, uint_least8_t count) {
+    uint_least8_t i;
+
+    timer = handle;
+    tickMs = period;
+    periodCounts = period * 1000u * Scheduler_COUNTS_PER_US;
+    tasks = table;
+    taskCount = count;
+    tickCount = 0;
+
+    for (i = 0; i < count; i++) {
+        tasks[i].elapsedMs = 0;
+        tasks[i].stats.runs = 0;
+        tasks[i].stats.overruns = 0;
+        tasks[i].stats.overBudget = 0;
+        tasks[i].stats.maxCounts = 0;
+        tasks[i].stats.totalCounts = 0;
+    }
+}
+
+/*
+ *  ======== Scheduler_tick ========
+ *  Called from the timer interrupt; keeps the timebase for task costs.
+ */
+void Scheduler_tick(void) {
+    tickCount++;
+    stats.ticks++;
+}
+
+/*
+ *  ======== Scheduler_run ========
+ *  Advance by ticks and run every task that has become due. Returns at
+ *  once if ticks is zero.
+ */
+void Scheduler_run(uint32_t ticks) {
+    uint32_t releases;
+    uint32_t cost;
+    uint64_t start;
+    uint_least8_t i;
+
+    if (ticks == 0) {
+        return;
+    }
+    stats.passes++;
+    stats.lateTicks += ticks - 1;
+
+    for (i = 0; i < taskCount; i++) {
+        Scheduler_Task *task = &tasks[i];
+
+        task->elapsedMs += ticks * tickMs;
+        if (task->elapsedMs < task->periodMs) {
+            continue;
+        }
+        releases = task->elapsedMs / task->periodMs;
+        task->elapsedMs -= releases * task->periodMs;
+        task->stats.overruns += releases - 1;
+
+        start = nowCounts();
+        task->fxn();
+        cost = (uint32_t)(nowCounts() - start);
+
+        task->stats.runs++;
+        task->stats.totalCounts += cost;
+        if (cost > task->stats.maxCounts) {
+            task->stats.maxCounts = cost;
+        }
+        if (task->budgetUs != 0 && cost > task->budgetUs * Scheduler_COUNTS_PER_US) {
+            task->stats.overBudget++;
+        }
+    }
+}
+
+/*
+ *  ======== Scheduler_getStats ========
+ */
+void Scheduler_getStats(Scheduler_Stats *out) {
+    uintptr_t key = HwiP_disable();
+
+    *out = stats;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== Scheduler_getTaskStats ========
+ *  Returns false if id is not a task in the table.
+ */
+bool Scheduler_getTaskStats(uint_least8_t id, Scheduler_TaskStats *out) {
+    if (id >= taskCount) {
+        return false;
+    }
+    *out = tasks[id].stats;
+    return true;
+}
@@ -0,0 +1,57 @@
+/*
+ *  ======== Scheduler.h ========
+ *  Multi-rate cooperative task scheduler for the NoRTOS main loop.
+ *
+ *  A periodic Timer interrupt calls Scheduler_tick() and posts an
+ *  EventQueue_TICK event. The main loop passes the number of tick events it
+ *  consumed to Scheduler_run(), which releases every task whose period has
+ *  elapsed and runs it to completion in table order. Task periods are multiples of the
+ *  tick period. A task may declare a cost budget; runs that exceed it are
+ *  counted, so a task that creeps toward its tick share shows up early.
+ */
+
+#ifndef Scheduler_h
+#define Scheduler_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/drivers/Timer.h>
+
+#ifndef Scheduler_COUNTS_PER_US
+#define Scheduler_COUNTS_PER_US  80u  /* Timer_getCount() runs at the 80 MHz system clock */
+#endif
+
+typedef void (*Scheduler_TaskFxn)(void);
+
+typedef struct {
+    uint32_t runs;         /* Times the task ran */
+    uint32_t overruns;     /* Releases lost because the task could not run in time */
+    uint32_t overBudget;   /* Runs that took longer than budgetUs */
+    uint32_t maxCounts;    /* Longest run, in timer counts */
+    uint64_t totalCounts;  /* Sum of all runs, in timer counts */
+} Scheduler_TaskStats;
+
+typedef struct {
+    const char        *name;
+    uint32_t           periodMs;
+    Scheduler_TaskFxn  fxn;
+    uint32_t           budgetUs;   /* Expected worst-case cost per run, 0 = unchecked */
+    uint32_t           elapsedMs;  /* Time since the last release; owned by the scheduler */
+    Scheduler_TaskStats stats;
+} Scheduler_Task;
+
+typedef struct {
+    uint32_t ticks;      /* Timer ticks seen */
+    uint32_t lateTicks;  /* Ticks handled in the same pass as an earlier one */
+    uint32_t passes;     /* Scheduler_run() calls that handled at least one tick */
+} Scheduler_Stats;
+
+extern void Scheduler_init(Timer_Handle timer, uint32_t tickMs,
+                           Scheduler_Task *tasks, uint_least8_t count);
+extern void Scheduler_tick(void);
+extern void Scheduler_run(uint32_t ticks);
+extern void Scheduler_getStats(Scheduler_Stats *stats);
+extern bool Scheduler_getTaskStats(uint_least8_t id, Scheduler_TaskStats *stats);
+
+#endif /* Scheduler_h */
@@ -0,0 +1,111 @@
+/*
+ *  ======== SensorCache.c ========
+ *  The file holds one fixed-size record. The network processor owns the
+ *  serial flash, so each call starts it, does one file operation and stops
+ *  it again; nothing else in the thermostat needs it running. Built with
+ *  SENSOR_FAST_BOOT off, there is no file and no SimpleLink reference.
+ */
+
+#include <stddef.h>
+
+#include "SensorCache.h"
+
+#if SENSOR_FAST_BOOT
+
+#include <ti/drivers/net/wifi/simplelink.h>
+
+#define MAGIC       0x54534331u  /* "TSC1" */
+#define NWP_STOP_MS 200
+
+typedef struct {
+    uint32_t magic;
+    uint8_t  index;
+    uint8_t  address;
+    uint16_t check;
+} Record;
+
+/*
+ *  ======== checkWord ========
+ */
+static uint16_t checkWord(const Record *record) {
+    return (uint16_t)~(((uint16_t)record->index << 8) | record->address);
+}
+
+/*
+ *  ======== SensorCache_load ========
+ *  Returns false if there is no valid entry.
+ */
+bool SensorCache_load(SensorCache_Entry *entry) {
+    Record record;
+    _i32 fd;
+    _i32 count;
+
+    if (sl_Start(NULL, NULL, NULL) < 0) {
+        return false;
+    }
+    fd = sl_FsOpen((const _u8 *)SensorCache_FILE, SL_FS_READ, NULL);
+    if (fd < 0) {
+        sl_Stop(NWP_STOP_MS);
+        return false;
+    }
+    count = sl_FsRead(fd, 0, (_u8 *)&record, sizeof(record));
+    sl_FsClose(fd, NULL, NULL, 0);
+    sl_Stop(NWP_STOP_MS);
+
+    if (count != sizeof(record) || record.magic != MAGIC || record.check != checkWord(&record)) {
+        return false;
+    }
+    entry->index = record.index;
+    entry->address = record.address;
+    return true;
+}
+
+/*
+ *  ======== SensorCache_store ========
+ *  Replaces the entry. Returns false if the file could not be written.
+ */
+bool SensorCache_store(const SensorCache_Entry *entry) {
+    Record record;
+    _i32 fd;
+    _i32 count;
+
+    record.magic = MAGIC;
+    record.index = entry->index;
+    record.address = entry->address;
+    record.check = checkWord(&record);
+
+    if (sl_Start(NULL, NULL, NULL) < 0) {
+        return false;
+    }
+    fd = sl_FsOpen((const _u8 *)SensorCache_FILE,
+                   SL_FS_CREATE | SL_FS_OVERWRITE | SL_FS_CREATE_MAX_SIZE(sizeof(record)), NULL);
+    if (fd < 0) {
+        sl_Stop(NWP_STOP_MS);
+        return false;
+    }
+    count = sl_FsWrite(fd, 0, (_u8 *)&record, sizeof(record));
+    sl_FsClose(fd, NULL, NULL, 0);
+    sl_Stop(NWP_STOP_MS);
+
+    return count == sizeof(record);
+}
+
+#else
+
+/*
+ *  ======== SensorCache_load ========
+ */
+bool SensorCache_load(SensorCache_Entry *entry) {
+    (void)entry;
+    return false;
+}
+
+/*
+ *  ======== SensorCache_store ========
+ */
+bool SensorCache_store(const SensorCache_Entry *entry) {
+    (void)entry;
+    return false;
+}
+
+#endif /* SENSOR_FAST_BOOT */
@@ -0,0 +1,42 @@
+/*
+ *  ======== SensorCache.h ========
+ *  Remembers which temperature sensor the last boot found, in a small file
+ *  on the SimpleLink serial flash file system.
+ *
+ *  On boot the application loads the entry and checks it against the bus
+ *  with a single transaction; only if that fails does it sweep every known
+ *  sensor and store what it finds. An entry that fails its check word, or
+ *  a missing file, reads as no entry.
+ */
+
+#ifndef SensorCache_h
+#define SensorCache_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ *  Off unless the build turns it on. The cache needs the SimpleLink host
+ *  driver, which the CCS project does not link, and the network processor
+ *  start and stop around each access have not been measured against the
+ *  probe they are meant to save. With it off, SensorCache_load() finds no
+ *  entry and SensorCache_store() stores nothing. The host build turns it
+ *  on; its SimpleLink stand-in keeps the file under hostfs/.
+ */
+#ifndef SENSOR_FAST_BOOT
+#define SENSOR_FAST_BOOT  0
+#endif
+
+#ifndef SensorCache_FILE
+#define SensorCache_FILE  "/thermostat/sensor.bin"
+#endif
+
+typedef struct {
+    uint8_t index;    /* Driver in TempSensor_drivers[] */
+    uint8_t address;  /* 7-bit I2C address it answered at */
+} SensorCache_Entry;
+
+extern bool SensorCache_load(SensorCache_Entry *entry);
+extern bool SensorCache_store(const SensorCache_Entry *entry);
+
+#endif /* SensorCache_h */
@@ -0,0 +1,339 @@
+/*
+ *  ======== Telemetry.c ========
+ *  ASCII, COBS-framed binary and delta encoders for the status record.
+ *  The binary and delta paths use no formatting calls.
+ */
+
+#include <stdio.h>  // For snprintf()
+
+#include "Telemetry.h"
+
+static Telemetry_Mode mode = Telemetry_DEFAULT_MODE;
+static uint8_t sequence = 0;
+static bool resync = true;  /* Send a lone delimiter before the first frame */
+
+/* Last record sent per zone in delta mode; a zone without one gets a keyframe */
+typedef struct {
+    Telemetry_Record last;
+    uint8_t          sinceKeyframe;
+    bool             valid;
+} DeltaState;
+
+static DeltaState deltaState[Telemetry_DELTA_ZONES];
+
+/* CRC-16/CCITT-FALSE, one nibble at a time to keep the table at 32 bytes */
+static const uint16_t crcNibbleTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/*
+ *  ======== putLe16 ========
+ */
+static uint8_t *putLe16(uint8_t *p, uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    return p + 2;
+}
+
+/*
+ *  ======== putLe32 ========
+ */
+static uint8_t *putLe32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+    return p + 4;
+}
+
+/*
+ *  ======== putVarint ========
+ */
+static uint8_t *putVarint(uint8_t *p, uint32_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+/*
+ *  ======== Telemetry_setMode ========
+ *  Takes effect with the next record. Entering delta mode starts every
+ *  zone with a keyframe.
+ */
+void Telemetry_setMode(Telemetry_Mode newMode) {
+    uint8_t i;
+
+    if (newMode != Telemetry_MODE_ASCII && mode == Telemetry_MODE_ASCII) {
+        resync = true;
+    }
+    if (newMode == Telemetry_MODE_DELTA && mode != Telemetry_MODE_DELTA) {
+        for (i = 0; i < Telemetry_DELTA_ZONES; i++) {
+            deltaState[i].valid = false;
+        }
+    }
+    mode = newMode;
+}
+
+Telemetry_Mode Telemetry_getMode(void) {
+    return mode;
+}
+
+/*
+ *  ======== Telemetry_crc16 ========
+ *  CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF.
+ */
+uint16_t Telemetry_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc = (uint16_t)((crc << 4) ^ crcNibbleTable[(crc >> 12) ^ (*data >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ crcNibbleTable[(crc >> 12) ^ (*data & 0x0F)]);
+        data++;
+    }
+    return crc;
+}
+
+/*
+ *  ======== Telemetry_zigzag ========
+ *  Signed to unsigned so that small magnitudes of either sign stay small.
+ */
+uint32_t Telemetry_zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+int32_t Telemetry_unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/*
+ *  ======== Telemetry_cobsEncode ========
+ *  Consistent Overhead Byte Stuffing of len bytes (len < 254) followed by
+ *  the 0x00 delimiter. dst must hold len + 2 bytes. Returns bytes written.
+ */
+size_t Telemetry_cobsEncode(const uint8_t *src, size_t len, uint8_t *dst) {
+    uint8_t *code = dst;
+    uint8_t *out = dst + 1;
+    uint8_t run = 1;
+
+    while (len--) {
+        if (*src == 0) {
+            *code = run;
+            code = out++;
+            run = 1;
+        } else {
+            *out++ = *src;
+            run++;
+        }
+        src++;
+    }
+    *code = run;
+    *out++ = 0x00;
+    return (size_t)(out - dst);
+}
+
+/*
+ *  ======== putRecord ========
+ *  The Telemetry_RECORD_LEN bytes shared by sample and batch packets.
+ */
+static uint8_t *putRecord(uint8_t *p, const Telemetry_Record *record) {
+    p = putLe16(p, (uint16_t)(int16_t)record->roomTemperature);
+    p = putLe16(p, (uint16_t)(int16_t)record->setPoint);
+    *p++ = (uint8_t)((record->zone << Telemetry_FLAG_ZONE_SHIFT) | (record->heaterOn ? Telemetry_FLAG_HEATER : 0));
+    return putLe32(p, record->timeCounter);
+}
+
+/*
+ *  ======== cobsFrame ========
+ *  COBS-frame a finished packet of len bytes into buffer, which must hold
+ *  len + 3 bytes.
+ */
+static size_t cobsFrame(const uint8_t *packet, size_t len, uint8_t *buffer) {
+    size_t out = 0;
+
+    if (resync) {
+        buffer[out++] = 0x00;  /* Terminates any text already on the line */
+        resync = false;
+    }
+    return out + Telemetry_cobsEncode(packet, len, buffer + out);
+}
+
+/*
+ *  ======== frame ========
+ *  Append the CRC to a packet of len bytes (room for it included in len)
+ *  and COBS-frame it into buffer, which must hold len + 3 bytes.
+ */
+static size_t frame(uint8_t *packet, size_t len, uint8_t *buffer) {
+    putLe16(packet + len - 2, Telemetry_crc16(packet, len - 2));
+    return cobsFrame(packet, len, buffer);
+}
+
+/*
+ *  ======== encodeBinary ========
+ */
+static size_t encodeBinary(const Telemetry_Record *record, uint8_t *buffer, size_t size) {
+    uint8_t packet[Telemetry_PAYLOAD_LEN];
+    uint8_t *p = packet;
+
+    if (size < Telemetry_PAYLOAD_LEN + 3) {
+        return 0;
+    }
+
+    *p++ = (Telemetry_VERSION << 4) | Telemetry_TYPE_SAMPLE;
+    *p++ = sequence++;
+    putRecord(p, record);
+    return frame(packet, Telemetry_PAYLOAD_LEN, buffer);
+}
+
+/*
+ *  ======== encodeDelta ========
+ *  A delta packet against the zone's last record, or a keyframe when the
+ *  zone has none or is due one.
+ */
+static size_t encodeDelta(const Telemetry_Record *record, uint8_t *buffer, size_t size) {
+    uint8_t packet[Telemetry_DELTA_MAX_LEN];
+    uint8_t *p = packet + 2;
+    DeltaState *state;
+    const Telemetry_Record *last;
+    uint8_t mask = 0;
+
+    if (size < Telemetry_PAYLOAD_LEN + 3) {
+        return 0;  /* Room for a keyframe, the larger packet */
+    }
+    if (record->zone >= Telemetry_DELTA_ZONES) {
+        packet[0] = (Telemetry_VERSION << 4) | Telemetry_TYPE_KEYFRAME;
+        packet[1] = sequence++;
+        putRecord(packet + 2, record);
+        return frame(packet, Telemetry_PAYLOAD_LEN, buffer);
+    }
+
+    state = &deltaState[record->zone];
+    last = &state->last;
+    if (!state->valid || ++state->sinceKeyframe >= Telemetry_KEYFRAME_INTERVAL) {
+        state->last = *record;
+        state->sinceKeyframe = 0;
+        state->valid = true;
+        packet[0] = (Telemetry_VERSION << 4) | Telemetry_TYPE_KEYFRAME;
+        packet[1] = sequence++;
+        putRecord(packet + 2, record);
+        return frame(packet, Telemetry_PAYLOAD_LEN, buffer);
+    }
+
+    if (record->zone != 0) {
+        mask |= Telemetry_DELTA_ZONE;
+        p = putVarint(p, record->zone);
+    }
+    if (record->roomTemperature != last->roomTemperature) {
+        mask |= Telemetry_DELTA_TEMP;
+        p = putVarint(p, Telemetry_zigzag(record->roomTemperature - last->roomTemperature));
+    }
+    if (record->setPoint != last->setPoint) {
+        mask |= Telemetry_DELTA_SET_POINT;
+        p = putVarint(p, Telemetry_zigzag(record->setPoint - last->setPoint));
+    }
+    if (record->heaterOn != last->heaterOn) {
+        mask |= Telemetry_DELTA_HEATER;
+    }
+    if (record->timeCounter - last->timeCounter != 1) {
+        mask |= Telemetry_DELTA_TIME;
+        p = putVarint(p, record->timeCounter - last->timeCounter);
+    }
+    packet[0] = Telemetry_DELTA_HEADER | mask;
+    packet[1] = sequence++;
+    *p = (uint8_t)Telemetry_crc16(packet, (size_t)(p - packet));
+    p++;
+
+    state->last = *record;
+    return cobsFrame(packet, (size_t)(p - packet), buffer);
+}
+
+/*
+ *  ======== encodeBinaryBatch ========
+ */
+static size_t encodeBinaryBatch(const Telemetry_Record *records, size_t count, uint8_t *buffer, size_t size) {
+    uint8_t packet[Telemetry_BATCH_PAYLOAD_LEN(Telemetry_BATCH_MAX_RECORDS)];
+    uint8_t *p = packet;
+    size_t len = Telemetry_BATCH_PAYLOAD_LEN(count);
+    size_t i;
+
+    if (count > Telemetry_BATCH_MAX_RECORDS || size < len + 3) {
+        return 0;
+    }
+
+    *p++ = (Telemetry_VERSION << 4) | Telemetry_TYPE_BATCH;
+    *p++ = sequence++;
+    *p++ = (uint8_t)count;
+    for (i = 0; i < count; i++) {
+        p = putRecord(p, &records[i]);
+    }
+    return frame(packet, len, buffer);
+}
+
+/*
+ *  ======== encodeAscii ========
+ */
+static size_t encodeAscii(const Telemetry_Record *record, uint8_t *buffer, size_t size) {
+    char tempText[TempConv_FORMAT_LEN];
+    int len;
+
+    /* RoomTemp is sent with three decimals so every 1/128 degree step survives */
+    TempConv_format(tempText, record->roomTemperature);
+    if (record->zone == 0) {
+        len = snprintf((char *)buffer, size, "<%s,%02d,%d,%04u>\r\n",
+                       tempText, record->setPoint, record->heaterOn ? 1 : 0,
+                       (unsigned)record->timeCounter);
+    } else {
+        len = snprintf((char *)buffer, size, "<%s,%02d,%d,%04u,%u>\r\n",
+                       tempText, record->setPoint, record->heaterOn ? 1 : 0,
+                       (unsigned)record->timeCounter, (unsigned)record->zone);
+    }
+    return (len < 0 || (size_t)len >= size) ? 0 : (size_t)len;
+}
+
+/*
+ *  ======== Telemetry_encode ========
+ *  Encode one record in the current mode. Returns the number of bytes
+ *  written, or 0 if the buffer is too small.
+ */
+size_t Telemetry_encode(const Telemetry_Record *record, uint8_t *buffer, size_t size) {
+    if (mode == Telemetry_MODE_BINARY) {
+        return encodeBinary(record, buffer, size);
+    }
+    if (mode == Telemetry_MODE_DELTA) {
+        return encodeDelta(record, buffer, size);
+    }
+    return encodeAscii(record, buffer, size);
+}
+
+/*
+ *  ======== Telemetry_encodeBatch ========
+ *  Encode count records (1 to Telemetry_BATCH_MAX_RECORDS) as one write in
+ *  the current mode. ASCII lines and delta packets are simply placed back
+ *  to back. Returns the number of bytes written, or 0 if the buffer is too
+ *  small for all of them.
+ */
+size_t Telemetry_encodeBatch(const Telemetry_Record *records, size_t count, uint8_t *buffer, size_t size) {
+    size_t total = 0, len;
+    size_t i;
+
+    if (count == 0) {
+        return 0;
+    }
+    if (count == 1) {
+        return Telemetry_encode(records, buffer, size);  /* A lone record keeps the sample format */
+    }
+    if (mode == Telemetry_MODE_BINARY) {
+        return encodeBinaryBatch(records, count, buffer, size);
+    }
+    for (i = 0; i < count; i++) {
+        len = Telemetry_encode(&records[i], buffer + total, size - total);
+        if (len == 0) {
+            return 0;
+        }
+        total += len;
+    }
+    return total;
+}
@@ -0,0 +1,132 @@
+/*
+ *  ======== Telemetry.h ========
+ *  Encoder for the once-per-tick status record sent over UART.
+ *
+ *  Telemetry_MODE_ASCII produces the original text line,
+ *      <RoomTemp,SetPoint,HeaterStatus,TimeCounter>\r\n
+ *  for zone 0, and the same line with a fifth field, the zone number, for
+ *  any other zone.
+ *  Telemetry_MODE_BINARY produces a COBS-framed packet terminated by 0x00:
+ *
+ *      offset  size  field
+ *      0       1     version (high nibble) and record type (low nibble)
+ *      1       1     sequence number, increments per record
+ *      2       2     room temperature, int16 Q7 (1/128 degree C)
+ *      4       2     set point, int16 degrees C
+ *      6       1     flags, bit 0 = heater on, bits 7:4 = zone
+ *      7       4     time counter, uint32 seconds
+ *      11      2     CRC-16/CCITT-FALSE of bytes 0-10
+ *
+ *  Telemetry_encodeBatch() sends several records at once. In ASCII mode
+ *  that is just their lines back to back; in binary mode it is one frame
+ *  of type Telemetry_TYPE_BATCH that shares the header and CRC:
+ *
+ *      offset  size  field
+ *      0       1     version (high nibble) and record type (low nibble)
+ *      1       1     sequence number, increments per frame
+ *      2       1     record count n, 1 to Telemetry_BATCH_MAX_RECORDS
+ *      3       9n    records, each bytes 2-10 of the sample packet
+ *      3+9n    2     CRC-16/CCITT-FALSE of the preceding bytes
+ *
+ *  Telemetry_MODE_DELTA sends each record against the previous record of
+ *  the same zone, also COBS-framed. The first record of a zone, and every
+ *  Telemetry_KEYFRAME_INTERVAL-th after it, is a keyframe: the sample
+ *  packet with record type Telemetry_TYPE_KEYFRAME. The others are delta
+ *  packets of 3 to Telemetry_DELTA_MAX_LEN bytes:
+ *
+ *      offset  size  field
+ *      0       1     0x80 | mask of the fields that follow (Telemetry_DELTA_*)
+ *      1       1     sequence number, shared with keyframes
+ *      2       -     varints, in mask bit order, for the fields present:
+ *                      zone        zone number, present when not zone 0
+ *                      temp        zigzag room temperature change, Q7
+ *                      set point   zigzag set point change
+ *                      heater      no bytes; the heater state toggled
+ *                      time        time counter step, present when not 1
+ *      n-1     1     low byte of the CRC-16/CCITT-FALSE of bytes 0 to n-2
+ *
+ *  Varints carry 7 bits per byte, least significant first, with bit 7 set
+ *  on every byte but the last. Zigzag maps 0, -1, 1, -2 ... to 0, 1, 2, 3
+ *  ... so small changes of either sign take one byte. A record where only
+ *  the time advanced is 3 bytes before framing, against 13 for a sample.
+ *  A decoder that sees a sequence gap must wait for each zone's next
+ *  keyframe. Zones from Telemetry_DELTA_ZONES up are always keyframes.
+ *
+ *  Multi-byte fields are little-endian. host/tools/telemetry_decode.c is
+ *  the matching decoder.
+ */
+
+#ifndef Telemetry_h
+#define Telemetry_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "TempConv.h"
+
+#define Telemetry_VERSION           1
+#define Telemetry_TYPE_SAMPLE       1
+#define Telemetry_TYPE_BATCH        2
+#define Telemetry_TYPE_KEYFRAME     3
+
+#define Telemetry_PAYLOAD_LEN       13  /* Packet including CRC, before framing */
+#define Telemetry_MAX_LEN           64  /* Largest encoded record in either mode */
+#define Telemetry_RECORD_LEN        9   /* Bytes per record inside a packet */
+
+#define Telemetry_BATCH_MAX_RECORDS 16
+#define Telemetry_BATCH_PAYLOAD_LEN(n)  (5 + Telemetry_RECORD_LEN * (n))
+
+/* Framed size, with COBS overhead and delimiter, of a sample or batch packet */
+#define Telemetry_SAMPLE_FRAME_LEN      (Telemetry_PAYLOAD_LEN + 2)
+#define Telemetry_BATCH_FRAME_LEN(n)    (Telemetry_BATCH_PAYLOAD_LEN(n) + 2)
+
+#define Telemetry_FLAG_HEATER       0x01
+#define Telemetry_FLAG_ZONE_SHIFT   4
+#define Telemetry_MAX_ZONES         16
+
+/* Delta packet header and field mask */
+#define Telemetry_DELTA_HEADER      0x80
+#define Telemetry_DELTA_ZONE        0x01
+#define Telemetry_DELTA_TEMP        0x02
+#define Telemetry_DELTA_SET_POINT   0x04
+#define Telemetry_DELTA_HEATER      0x08
+#define Telemetry_DELTA_TIME        0x10
+#define Telemetry_DELTA_MASK        0x1F
+#define Telemetry_DELTA_MAX_LEN     17  /* Header, sequence, 1+3+5+5 varint bytes, check */
+
+#ifndef Telemetry_KEYFRAME_INTERVAL
+#define Telemetry_KEYFRAME_INTERVAL 16  /* Records per zone from one keyframe to the next */
+#endif
+#ifndef Telemetry_DELTA_ZONES
+#define Telemetry_DELTA_ZONES       4   /* Zones with delta state; RAM per zone is one record */
+#endif
+
+#ifndef Telemetry_DEFAULT_MODE
+#define Telemetry_DEFAULT_MODE      Telemetry_MODE_ASCII
+#endif
+
+typedef enum {
+    Telemetry_MODE_ASCII,
+    Telemetry_MODE_BINARY,
+    Telemetry_MODE_DELTA
+} Telemetry_Mode;
+
+typedef struct {
+    TempConv_Q7 roomTemperature;
+    int         setPoint;
+    bool        heaterOn;
+    uint32_t    timeCounter;
+    uint8_t     zone;
+} Telemetry_Record;
+
+extern void Telemetry_setMode(Telemetry_Mode mode);
+extern Telemetry_Mode Telemetry_getMode(void);
+extern size_t Telemetry_encode(const Telemetry_Record *record, uint8_t *buffer, size_t size);
+extern size_t Telemetry_encodeBatch(const Telemetry_Record *records, size_t count, uint8_t *buffer, size_t size);
+extern size_t Telemetry_cobsEncode(const uint8_t *src, size_t len, uint8_t *dst);
+extern uint16_t Telemetry_crc16(const uint8_t *data, size_t len);
+extern uint32_t Telemetry_zigzag(int32_t value);
+extern int32_t Telemetry_unzigzag(uint32_t value);
+
+#endif /* Telemetry_h */
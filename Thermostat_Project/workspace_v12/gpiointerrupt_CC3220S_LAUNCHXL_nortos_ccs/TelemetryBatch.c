@@ -0,0 +1,112 @@
+/*
+ *  ======== TelemetryBatch.c ========
+ *  Buffers status records and writes them to UartTx in batches.
+ *  Called from the main loop only.
+ */
+
+#include "TelemetryBatch.h"
+#include "UartTx.h"
+
+static Telemetry_Record records[TelemetryBatch_MAX_RECORDS];
+static uint8_t output[TelemetryBatch_BUFFER_SIZE];
+static uint8_t count;
+static uint8_t batchSize = 1;
+static uint32_t flushIntervalMs;
+static uint32_t ageMs;  /* Time the oldest buffered record has waited */
+
+static TelemetryBatch_Stats stats;
+
+/*
+ *  ======== TelemetryBatch_init ========
+ *  flushMs of 0 disables the interval; batches then go out only when full.
+ */
+void TelemetryBatch_init(uint8_t size, uint32_t flushMs) {
+    count = 0;
+    ageMs = 0;
+    flushIntervalMs = flushMs;
+    if (!TelemetryBatch_setSize(size)) {
+        batchSize = 1;
+    }
+}
+
+/*
+ *  ======== TelemetryBatch_setSize ========
+ *  Takes effect at once; a batch already at the new size is flushed.
+ *  Returns false, changing nothing, if size is 0 or above
+ *  TelemetryBatch_MAX_RECORDS.
+ */
+bool TelemetryBatch_setSize(uint8_t size) {
+    if (size == 0 || size > TelemetryBatch_MAX_RECORDS) {
+        return false;
+    }
+    batchSize = size;
+    if (count >= batchSize) {
+        stats.fullFlushes++;
+        TelemetryBatch_flush();
+    }
+    return true;
+}
+
+uint8_t TelemetryBatch_getSize(void) {
+    return batchSize;
+}
+
+/*
+ *  ======== TelemetryBatch_add ========
+ */
+void TelemetryBatch_add(const Telemetry_Record *record) {
+    records[count++] = *record;
+    stats.records++;
+    if (count >= batchSize) {
+        stats.fullFlushes++;
+        TelemetryBatch_flush();
+    }
+}
+
+/*
+ *  ======== TelemetryBatch_poll ========
+ *  Age the buffered records by elapsedMs and flush them once the oldest
+ *  has waited the flush interval.
+ */
+void TelemetryBatch_poll(uint32_t elapsedMs) {
+    if (count == 0) {
+        return;
+    }
+    ageMs += elapsedMs;
+    if (flushIntervalMs != 0 && ageMs >= flushIntervalMs) {
+        stats.timedFlushes++;
+        TelemetryBatch_flush();
+    }
+}
+
+/*
+ *  ======== TelemetryBatch_flush ========
+ *  Send whatever is buffered, in one write.
+ */
+void TelemetryBatch_flush(void) {
+    size_t length;
+
+    if (count == 0) {
+        return;
+    }
+    length = Telemetry_encodeBatch(records, count, output, sizeof(output));
+    if (length == 0 || UartTx_write(output, length) == 0) {
+        stats.dropped += count;
+    } else {
+        stats.flushes++;
+        stats.callsSaved += count - 1u;
+        stats.bytes += length;
+        if (count > 1 && Telemetry_getMode() == Telemetry_MODE_BINARY) {
+            stats.bytesSaved += count * Telemetry_SAMPLE_FRAME_LEN - Telemetry_BATCH_FRAME_LEN(count);
+        }
+    }
+    count = 0;
+    ageMs = 0;
+}
+
+/*
+ *  ======== TelemetryBatch_getStats ========
+ */
+void TelemetryBatch_getStats(TelemetryBatch_Stats *out) {
+    *out = stats;
+}
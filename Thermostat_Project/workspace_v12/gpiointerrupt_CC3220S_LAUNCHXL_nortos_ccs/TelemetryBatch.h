@@ -0,0 +1,55 @@
+/*
+ *  ======== TelemetryBatch.h ========
+ *  Batching stage between the report task and the UART queue.
+ *
+ *  TelemetryBatch_add() keeps the record in RAM. The buffered records go
+ *  out as one Telemetry_encodeBatch() and one UartTx_write() when the
+ *  batch reaches its size (the high-water mark), or when the oldest record
+ *  has waited the flush interval, whichever comes first. A batch size of 1
+ *  sends every record on its own, as before batching existed.
+ *
+ *  Records are encoded at flush time, so a mode change applies to the
+ *  records already buffered.
+ */
+
+#ifndef TelemetryBatch_h
+#define TelemetryBatch_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Telemetry.h"
+
+#ifndef TelemetryBatch_MAX_RECORDS
+#define TelemetryBatch_MAX_RECORDS  8
+#endif
+
+/* Encode buffer; ASCII lines with two-digit set-points are at most 32 bytes */
+#ifndef TelemetryBatch_BUFFER_SIZE
+#define TelemetryBatch_BUFFER_SIZE  (TelemetryBatch_MAX_RECORDS * 40)
+#endif
+
+#if TelemetryBatch_MAX_RECORDS > Telemetry_BATCH_MAX_RECORDS
+#error "TelemetryBatch_MAX_RECORDS exceeds Telemetry_BATCH_MAX_RECORDS"
+#endif
+
+typedef struct {
+    uint32_t records;       /* Records added */
+    uint32_t flushes;       /* UartTx_write() calls made */
+    uint32_t fullFlushes;   /* Flushes at the high-water mark */
+    uint32_t timedFlushes;  /* Flushes at the end of the interval */
+    uint32_t callsSaved;    /* Writes avoided versus one per record */
+    uint32_t bytes;         /* Bytes written */
+    uint32_t bytesSaved;    /* Framing avoided versus one binary frame per record */
+    uint32_t dropped;       /* Records lost to a full UART queue or encode buffer */
+} TelemetryBatch_Stats;
+
+extern void TelemetryBatch_init(uint8_t size, uint32_t flushMs);
+extern bool TelemetryBatch_setSize(uint8_t size);
+extern uint8_t TelemetryBatch_getSize(void);
+extern void TelemetryBatch_add(const Telemetry_Record *record);
+extern void TelemetryBatch_poll(uint32_t elapsedMs);
+extern void TelemetryBatch_flush(void);
+extern void TelemetryBatch_getStats(TelemetryBatch_Stats *stats);
+
+#endif /* TelemetryBatch_h */
@@ -0,0 +1,40 @@
+/*
+ *  ======== TempConv.c ========
+ *  Text output for Q7 temperatures without printf.
+ */
+
+#include "TempConv.h"
+
+/*
+ *  ======== TempConv_format ========
+ *  Writes the temperature as "[-]D.DDD" degrees and a terminator into
+ *  buffer, which must hold TempConv_FORMAT_LEN bytes. Returns the length.
+ */
+int TempConv_format(char *buffer, TempConv_Q7 q7) {
+    int32_t milli = TempConv_toMilli(q7);
+    uint32_t whole, frac;
+    char digits[4];
+    int len = 0, n = 0;
+
+    if (milli < 0) {
+        buffer[len++] = '-';
+        milli = -milli;
+    }
+    whole = (uint32_t)milli / 1000;
+    frac = (uint32_t)milli % 1000;
+
+    do {
+        digits[n++] = (char)('0' + whole % 10);
+        whole /= 10;
+    } while (whole != 0 && n < (int)sizeof(digits));
+    while (n > 0) {
+        buffer[len++] = digits[--n];
+    }
+
+    buffer[len++] = '.';
+    buffer[len++] = (char)('0' + frac / 100);
+    buffer[len++] = (char)('0' + frac / 10 % 10);
+    buffer[len++] = (char)('0' + frac % 10);
+    buffer[len] = '\0';
+    return len;
+}
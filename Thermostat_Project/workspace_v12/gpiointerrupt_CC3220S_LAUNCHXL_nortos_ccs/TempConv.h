@@ -0,0 +1,67 @@
+/*
+ *  ======== TempConv.h ========
+ *  Integer conversion of TMP sensor registers to Q7 fixed point.
+ *
+ *  A TempConv_Q7 holds degrees Celsius in units of 1/128 degree, the LSB
+ *  of the TMP11x temperature register. Conversions use shifts and masks
+ *  only, so no soft-float code is linked on the FPU-less CC3220.
+ */
+
+#ifndef TempConv_h
+#define TempConv_h
+
+#include <stdint.h>
+
+typedef int32_t TempConv_Q7;
+
+#define TempConv_Q7_SHIFT       7
+#define TempConv_Q7_ONE         (1 << TempConv_Q7_SHIFT)
+
+/* Longest TempConv_format() output, "-256.000" plus the terminator */
+#define TempConv_FORMAT_LEN     9
+
+/*
+ *  ======== TempConv_fromTmp006 ========
+ *  TMP006 die temperature: 14-bit two's complement, left justified, with a
+ *  1/32 degree LSB. The two unused low bits are cleared.
+ */
+static inline TempConv_Q7 TempConv_fromTmp006(uint16_t reg) {
+    return (TempConv_Q7)(int16_t)(reg & 0xFFFC);
+}
+
+/*
+ *  ======== TempConv_fromTmp11x ========
+ *  TMP116/TMP117 temperature: 16-bit two's complement, 1/128 degree LSB.
+ */
+static inline TempConv_Q7 TempConv_fromTmp11x(uint16_t reg) {
+    return (TempConv_Q7)(int16_t)reg;
+}
+
+/*
+ *  ======== TempConv_fromDegrees ========
+ */
+static inline TempConv_Q7 TempConv_fromDegrees(int degrees) {
+    return (TempConv_Q7)degrees * TempConv_Q7_ONE;
+}
+
+/*
+ *  ======== TempConv_toDegrees ========
+ *  Rounds to the nearest whole degree, halves away from zero.
+ */
+static inline int TempConv_toDegrees(TempConv_Q7 q7) {
+    return (q7 >= 0) ? (q7 + TempConv_Q7_ONE / 2) >> TempConv_Q7_SHIFT
+                     : -((-q7 + TempConv_Q7_ONE / 2) >> TempConv_Q7_SHIFT);
+}
+
+/*
+ *  ======== TempConv_toMilli ========
+ *  Milli-degrees, rounded. Every Q7 step maps to a distinct value.
+ */
+static inline int32_t TempConv_toMilli(TempConv_Q7 q7) {
+    return (q7 >= 0) ? (q7 * 1000 + TempConv_Q7_ONE / 2) >> TempConv_Q7_SHIFT
+                     : -((-q7 * 1000 + TempConv_Q7_ONE / 2) >> TempConv_Q7_SHIFT);
+}
+
+extern int TempConv_format(char *buffer, TempConv_Q7 q7);
+
+#endif /* TempConv_h */
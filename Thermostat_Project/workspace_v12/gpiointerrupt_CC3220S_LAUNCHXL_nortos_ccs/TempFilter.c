@@ -0,0 +1,133 @@
+/*
+ *  ======== TempFilter.c ========
+ *  Integer moving average, exponential moving average and sliding median.
+ *
+ *  The median keeps the window sorted incrementally. Replacing the oldest
+ *  sample moves only the entries between the old sample's position and the
+ *  new sample's position, one step each, so a sample costs at most one pass
+ *  over the window and nothing when the reading is steady.
+ */
+
+#include "TempFilter.h"
+
+/*
+ *  ======== divRound ========
+ *  Signed division rounding half away from zero.
+ */
+static int32_t divRound(int32_t value, int32_t divisor) {
+    return (value >= 0) ? (value + divisor / 2) / divisor : (value - divisor / 2) / divisor;
+}
+
+/*
+ *  ======== TempFilter_init ========
+ */
+void TempFilter_init(TempFilter *filter, TempFilter_Kind kind) {
+    filter->kind = kind;
+    TempFilter_reset(filter);
+}
+
+/*
+ *  ======== TempFilter_reset ========
+ *  Forget the window, e.g. after a sensor error.
+ */
+void TempFilter_reset(TempFilter *filter) {
+    filter->head = 0;
+    filter->count = 0;
+    filter->sum = 0;
+    filter->ema = 0;
+}
+
+/*
+ *  ======== TempFilter_update ========
+ *  Feed one sample through the filter chosen at init; returns its output.
+ */
+TempConv_Q7 TempFilter_update(TempFilter *filter, TempConv_Q7 sample) {
+    switch (filter->kind) {
+        case TempFilter_KIND_MEAN:
+            return TempFilter_mean(filter, sample);
+        case TempFilter_KIND_EMA:
+            return TempFilter_ema(filter, sample);
+        case TempFilter_KIND_MEDIAN:
+            return TempFilter_median(filter, sample);
+        case TempFilter_KIND_NONE:
+            break;
+    }
+    return sample;
+}
+
+/*
+ *  ======== TempFilter_mean ========
+ */
+TempConv_Q7 TempFilter_mean(TempFilter *filter, TempConv_Q7 sample) {
+    if (filter->count < TempFilter_WINDOW) {
+        filter->count++;
+    } else {
+        filter->sum -= filter->ring[filter->head];
+    }
+    filter->sum += sample;
+    filter->ring[filter->head] = sample;
+    filter->head = (filter->head + 1) % TempFilter_WINDOW;
+
+    return divRound(filter->sum, filter->count);
+}
+
+/*
+ *  ======== TempFilter_ema ========
+ *  The state keeps TempFilter_EMA_SHIFT extra fraction bits so small steps
+ *  are not lost to truncation. The first sample seeds the average.
+ */
+TempConv_Q7 TempFilter_ema(TempFilter *filter, TempConv_Q7 sample) {
+    int32_t scaled = sample * (1 << TempFilter_EMA_SHIFT);
+
+    if (filter->count == 0) {
+        filter->count = 1;
+        filter->ema = scaled;
+    } else {
+        filter->ema += divRound(scaled - filter->ema, 1 << TempFilter_EMA_SHIFT);
+    }
+    return divRound(filter->ema, 1 << TempFilter_EMA_SHIFT);
+}
+
+/*
+ *  ======== TempFilter_median ========
+ *  For an even count, the mean of the two middle samples.
+ */
+TempConv_Q7 TempFilter_median(TempFilter *filter, TempConv_Q7 sample) {
+    TempConv_Q7 *sorted = filter->sorted;
+    uint8_t i;
+    uint8_t n;
+
+    if (filter->count < TempFilter_WINDOW) {
+        /* Still filling: insertion step into the sorted prefix */
+        i = filter->count++;
+        while (i > 0 && sorted[i - 1] > sample) {
+            sorted[i] = sorted[i - 1];
+            i--;
+        }
+    } else {
+        /* Find the sample leaving the window, then slide its slot into place */
+        TempConv_Q7 oldest = filter->ring[filter->head];
+
+        i = 0;
+        while (sorted[i] != oldest) {
+            i++;
+        }
+        while (i > 0 && sorted[i - 1] > sample) {
+            sorted[i] = sorted[i - 1];
+            i--;
+        }
+        while (i < TempFilter_WINDOW - 1 && sorted[i + 1] < sample) {
+            sorted[i] = sorted[i + 1];
+            i++;
+        }
+    }
+    sorted[i] = sample;
+    filter->ring[filter->head] = sample;
+    filter->head = (filter->head + 1) % TempFilter_WINDOW;
+
+    n = filter->count;
+    if (n & 1) {
+        return sorted[n / 2];
+    }
+    return divRound(sorted[n / 2 - 1] + sorted[n / 2], 2);
+}
@@ -0,0 +1,60 @@
+/*
+ *  ======== TempFilter.h ========
+ *  Streaming filters for TempConv_Q7 sensor samples, integer math only.
+ *
+ *  Each filter keeps a fixed window of the last TempFilter_WINDOW samples
+ *  in a ring buffer and updates its output per sample without rescanning
+ *  the window:
+ *    MEAN    running sum, one add and one subtract per sample
+ *    EMA     y += (x - y) / 2^TempFilter_EMA_SHIFT
+ *    MEDIAN  sorted copy of the window; the outgoing sample's slot is
+ *            slid to where the incoming one belongs, never re-sorted
+ *
+ *  Until the window fills, MEAN and MEDIAN use the samples seen so far.
+ */
+
+#ifndef TempFilter_h
+#define TempFilter_h
+
+#include <stdint.h>
+
+#include "TempConv.h"
+
+#ifndef TempFilter_WINDOW
+#define TempFilter_WINDOW     8   /* Samples in the MEAN and MEDIAN window */
+#endif
+
+#ifndef TempFilter_EMA_SHIFT
+#define TempFilter_EMA_SHIFT  2   /* EMA weight of a new sample is 1/4 */
+#endif
+
+typedef enum {
+    TempFilter_KIND_NONE,    /* Pass samples through */
+    TempFilter_KIND_MEAN,
+    TempFilter_KIND_EMA,
+    TempFilter_KIND_MEDIAN
+} TempFilter_Kind;
+
+#ifndef TempFilter_DEFAULT_KIND
+#define TempFilter_DEFAULT_KIND  TempFilter_KIND_MEDIAN
+#endif
+
+typedef struct {
+    TempFilter_Kind kind;
+    uint8_t         head;    /* Ring slot the next sample goes into */
+    uint8_t         count;   /* Samples in the window, up to TempFilter_WINDOW */
+    int32_t         sum;     /* MEAN: sum of the window */
+    int32_t         ema;     /* EMA: output scaled by 2^TempFilter_EMA_SHIFT */
+    TempConv_Q7     ring[TempFilter_WINDOW];
+    TempConv_Q7     sorted[TempFilter_WINDOW];  /* MEDIAN: the window in ascending order */
+} TempFilter;
+
+extern void TempFilter_init(TempFilter *filter, TempFilter_Kind kind);
+extern void TempFilter_reset(TempFilter *filter);
+extern TempConv_Q7 TempFilter_update(TempFilter *filter, TempConv_Q7 sample);
+
+extern TempConv_Q7 TempFilter_mean(TempFilter *filter, TempConv_Q7 sample);
+extern TempConv_Q7 TempFilter_ema(TempFilter *filter, TempConv_Q7 sample);
+extern TempConv_Q7 TempFilter_median(TempFilter *filter, TempConv_Q7 sample);
+
+#endif /* TempFilter_h */
@@ -0,0 +1,181 @@
+/*
+ *  ======== TempPipeline.c ========
+ *  Callback-mode I2C reader for the result registers of up to
+ *  TempPipeline_MAX_CHANNELS sensors on one bus.
+ *
+ *  A burst queues every channel's transaction with the driver at once, so
+ *  the controller moves from one to the next without waiting for the main
+ *  loop. Only one burst is in flight at a time; a trigger that arrives
+ *  while one is running is counted and dropped rather than queued, which
+ *  keeps the age of every result under one burst. Each result is posted to
+ *  the main loop as an EventQueue_SENSOR event carrying the channel, the
+ *  status and the register value, so the receive buffers are free again as
+ *  soon as the callback returns.
+ */
+
+#include <stddef.h>
+
+#include <ti/drivers/I2C.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/devices/cc32xx/driverlib/prcm.h>
+
+#include "TempPipeline.h"
+#include "EventQueue.h"
+
+#define BIT_RATE_HZ  400000u
+
+static I2C_Handle i2c;
+static I2C_Transaction transactions[TempPipeline_MAX_CHANNELS];
+static uint8_t txBuffers[TempPipeline_MAX_CHANNELS][1];
+static uint8_t rxBuffers[TempPipeline_MAX_CHANNELS][2];
+static uint8_t channelCount;
+static uint32_t burstWireUs;
+
+static volatile uint8_t outstanding;  /* Set by TempPipeline_trigger(), counted down by the callback */
+static uint32_t burstStart;           /* Slow clock at the last trigger */
+
+static TempPipeline_Stats stats;
+
+/*
+ *  ======== wireBits ========
+ *  Bits one transaction occupies the bus for: start, address and data
+ *  bytes of nine bits each, repeated start and stop.
+ */
+static uint32_t wireBits(const I2C_Transaction *transaction) {
+    uint32_t bits = 2;
+
+    if (transaction->writeCount > 0) {
+        bits += 9 * (1 + transaction->writeCount);
+    }
+    if (transaction->readCount > 0) {
+        bits += 9 * (1 + transaction->readCount);
+    }
+    return bits;
+}
+
+/*
+ *  ======== transferCallback ========
+ *  Runs in interrupt context when a read finishes.
+ */
+static void transferCallback(I2C_Handle handle, I2C_Transaction *transaction, bool status) {
+    const uint8_t *rx = transaction->readBuf;
+    uint8_t channel = (uint8_t)(transaction - transactions);
+    uint16_t raw = 0;
+    uint32_t burstUs;
+
+    if (status) {
+        raw = (uint16_t)((rx[0] << 8) | rx[1]);
+        stats.completed++;
+    } else {
+        stats.failed++;
+    }
+    if (--outstanding == 0) {
+        burstUs = (uint32_t)((((uint64_t)((uint32_t)PRCMSlowClkCtrFastGet() - burstStart)) * 1000000u) >> 15);
+        if (burstUs > stats.maxBurstUs) {
+            stats.maxBurstUs = burstUs;
+        }
+    }
+    EventQueue_post(EventQueue_SENSOR, (uint8_t)((channel << 1) | (status ? 1 : 0)), raw, 0);
+}
+
+/*
+ *  ======== TempPipeline_open ========
+ *  Opens the I2C instance in callback mode at 400 kHz and primes the first
+ *  burst. The instance must not already be open.
+ */
+bool TempPipeline_open(uint_least8_t index, const TempPipeline_Channel *channels, uint8_t count) {
+    I2C_Params i2cParams;
+    uint32_t bits = 0;
+    uint8_t i;
+
+    if (count == 0 || count > TempPipeline_MAX_CHANNELS) {
+        return false;
+    }
+
+    I2C_Params_init(&i2cParams);
+    i2cParams.bitRate = I2C_400kHz;
+    i2cParams.transferMode = I2C_MODE_CALLBACK;
+    i2cParams.transferCallbackFxn = transferCallback;
+
+    i2c = I2C_open(index, &i2cParams);
+    if (i2c == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        channels[i].driver->prepareRead(channels[i].driver, channels[i].address,
+                                        &transactions[i], txBuffers[i], rxBuffers[i]);
+        bits += wireBits(&transactions[i]);
+    }
+    channelCount = count;
+    burstWireUs = (bits * 1000000u + BIT_RATE_HZ - 1) / BIT_RATE_HZ;
+    outstanding = 0;
+
+    return TempPipeline_trigger();
+}
+
+/*
+ *  ======== TempPipeline_trigger ========
+ *  Queue one read of every channel. Callable from thread or interrupt
+ *  context.
+ */
+bool TempPipeline_trigger(void) {
+    uintptr_t key;
+    uint8_t i;
+
+    key = HwiP_disable();
+    if (outstanding != 0) {
+        stats.busy++;
+        HwiP_restore(key);
+        return false;
+    }
+    outstanding = channelCount;
+    burstStart = (uint32_t)PRCMSlowClkCtrFastGet();
+    stats.bursts++;
+    stats.started += channelCount;
+
+    /* Queue with interrupts still masked so no completion sees a partial burst */
+    for (i = 0; i < channelCount; i++) {
+        if (!I2C_transfer(i2c, &transactions[i])) {
+            outstanding--;
+            stats.failed++;
+        }
+    }
+    HwiP_restore(key);
+    return true;
+}
+
+/*
+ *  ======== TempPipeline_result ========
+ *  Decode an event from the queue; anything but EventQueue_SENSOR is NONE.
+ *  *channel is set for NEW and ERROR.
+ */
+TempPipeline_Result TempPipeline_result(const EventQueue_Event *event, uint8_t *channel, int16_t *raw) {
+    if (event->type != EventQueue_SENSOR) {
+        return TempPipeline_RESULT_NONE;
+    }
+    *channel = event->arg >> 1;
+    if ((event->arg & 1) == 0) {
+        return TempPipeline_RESULT_ERROR;
+    }
+    *raw = (int16_t)event->value;
+    return TempPipeline_RESULT_NEW;
+}
+
+/*
+ *  ======== TempPipeline_burstWireUs ========
+ *  Time one burst occupies the bus at 400 kHz, from the transaction sizes.
+ */
+uint32_t TempPipeline_burstWireUs(void) {
+    return burstWireUs;
+}
+
+/*
+ *  ======== TempPipeline_getStats ========
+ */
+void TempPipeline_getStats(TempPipeline_Stats *out) {
+    uintptr_t key = HwiP_disable();
+
+    *out = stats;
+    HwiP_restore(key);
+}
@@ -0,0 +1,51 @@
+/*
+ *  ======== TempPipeline.h ========
+ *  Non-blocking temperature sensor reads using I2C_MODE_CALLBACK.
+ *
+ *  The pipeline owns one read per channel (sensor). TempPipeline_trigger()
+ *  queues the reads of every channel back to back as one burst on the bus.
+ *  Each completion arrives in the main loop as an EventQueue_SENSOR event,
+ *  which TempPipeline_result() decodes, so the caller never waits on the
+ *  bus.
+ */
+
+#ifndef TempPipeline_h
+#define TempPipeline_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "EventQueue.h"
+#include "TempSensor.h"
+
+#ifndef TempPipeline_MAX_CHANNELS
+#define TempPipeline_MAX_CHANNELS  4
+#endif
+
+typedef enum {
+    TempPipeline_RESULT_NONE,   /* Not a sensor event */
+    TempPipeline_RESULT_NEW,    /* *raw holds a fresh register value */
+    TempPipeline_RESULT_ERROR   /* The transfer was not acknowledged */
+} TempPipeline_Result;
+
+typedef struct {
+    const TempSensor_Driver *driver;
+    uint8_t                  address;
+} TempPipeline_Channel;
+
+typedef struct {
+    uint32_t bursts;      /* Triggers that put a burst on the bus */
+    uint32_t started;     /* Transfers put on the bus */
+    uint32_t completed;   /* Transfers that returned data */
+    uint32_t failed;      /* Transfers that failed */
+    uint32_t busy;        /* Triggers dropped because a burst was in flight */
+    uint32_t maxBurstUs;  /* Longest trigger-to-last-completion time, slow clock resolution */
+} TempPipeline_Stats;
+
+extern bool TempPipeline_open(uint_least8_t index, const TempPipeline_Channel *channels, uint8_t count);
+extern bool TempPipeline_trigger(void);
+extern TempPipeline_Result TempPipeline_result(const EventQueue_Event *event, uint8_t *channel, int16_t *raw);
+extern uint32_t TempPipeline_burstWireUs(void);
+extern void TempPipeline_getStats(TempPipeline_Stats *stats);
+
+#endif /* TempPipeline_h */
@@ -0,0 +1,85 @@
+/*
+ *  ======== TempSensor.c ========
+ *  TMP11X (TMP117/TMP119), TMP116 and TMP006 drivers. The three differ
+ *  only in their data, so they share the register-level hooks below; a
+ *  device that needs a different access sequence supplies its own.
+ *
+ *  TempSensor_drivers[] is also the probe order at boot, and its indices
+ *  are what SensorCache remembers, so new drivers go at the end.
+ */
+
+#include <stddef.h>
+
+#include "TempSensor.h"
+
+/*
+ *  ======== probeRegister ========
+ *  Address the result register without reading it.
+ */
+static bool probeRegister(I2C_Handle i2c, const TempSensor_Driver *driver, uint8_t address) {
+    I2C_Transaction transaction;
+    uint8_t tx[1];
+
+    transaction.slaveAddress = address;
+    tx[0] = driver->resultReg;
+    transaction.writeBuf = tx;
+    transaction.writeCount = 1;
+    transaction.readBuf = NULL;
+    transaction.readCount = 0;
+
+    return I2C_transfer(i2c, &transaction);
+}
+
+/*
+ *  ======== verifyId ========
+ */
+static bool verifyId(I2C_Handle i2c, const TempSensor_Driver *driver, uint8_t address) {
+    I2C_Transaction transaction;
+    uint8_t tx[1];
+    uint8_t rx[2];
+
+    transaction.slaveAddress = address;
+    tx[0] = driver->idReg;
+    transaction.writeBuf = tx;
+    transaction.writeCount = 1;
+    transaction.readBuf = rx;
+    transaction.readCount = 2;
+
+    if (!I2C_transfer(i2c, &transaction)) {
+        return false;
+    }
+    return (((rx[0] << 8) | rx[1]) & 0x0FFF) == driver->deviceId;
+}
+
+/*
+ *  ======== prepareRegisterRead ========
+ *  Pointer write then two-byte read, MSB first.
+ */
+static void prepareRegisterRead(const TempSensor_Driver *driver, uint8_t address,
+                                I2C_Transaction *transaction, uint8_t *tx, uint8_t *rx) {
+    tx[0] = driver->resultReg;
+    transaction->slaveAddress = address;
+    transaction->writeBuf = tx;
+    transaction->writeCount = 1;
+    transaction->readBuf = rx;
+    transaction->readCount = 2;
+}
+
+static const TempSensor_Driver tmp11x = {
+    "11X", 0x48, 0x00, 0x0F, 0x0117,
+    probeRegister, verifyId, prepareRegisterRead, TempConv_fromTmp11x
+};
+
+static const TempSensor_Driver tmp116 = {
+    "116", 0x49, 0x00, 0x0F, 0x0116,
+    probeRegister, verifyId, prepareRegisterRead, TempConv_fromTmp11x
+};
+
+static const TempSensor_Driver tmp006 = {
+    "006", 0x41, 0x01, 0xFF, 0x0067,
+    probeRegister, verifyId, prepareRegisterRead, TempConv_fromTmp006
+};
+
+/* In TempSensor_TMP11X, TempSensor_TMP116, TempSensor_TMP006 order */
+const TempSensor_Driver *const TempSensor_drivers[] = { &tmp11x, &tmp116, &tmp006 };
+const uint8_t TempSensor_DRIVER_COUNT = sizeof(TempSensor_drivers) / sizeof(TempSensor_drivers[0]);
@@ -0,0 +1,71 @@
+/*
+ *  ======== TempSensor.h ========
+ *  Driver table for the supported I2C temperature sensors.
+ *
+ *  Each driver describes one device family: where it answers, how to
+ *  recognise it, how to set up a result read and how to turn the result
+ *  register into a TempConv_Q7. The application picks a driver for each
+ *  sensor once, at detect time, and keeps the pointer; from then on
+ *  TempSensor_convert() is a single indirect call with no per-sample
+ *  branching. Adding a sensor means adding a driver to TempSensor_drivers[];
+ *  the control path does not change.
+ *
+ *  The hooks take the bus address, so one driver serves every sensor of
+ *  its family whatever address pins it is strapped to.
+ *
+ *  Builds for one known sensor can bind the conversion at compile time,
+ *  e.g. -DTempSensor_FIXED_CONVERT=TempConv_fromTmp006, which makes
+ *  TempSensor_convert() a direct inline call.
+ */
+
+#ifndef TempSensor_h
+#define TempSensor_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/drivers/I2C.h>
+
+#include "TempConv.h"
+
+/* Indices into TempSensor_drivers[], which is also the boot probe order */
+#define TempSensor_TMP11X   0
+#define TempSensor_TMP116   1
+#define TempSensor_TMP006   2
+
+typedef struct TempSensor_Driver TempSensor_Driver;
+
+struct TempSensor_Driver {
+    const char *id;        /* Short name for console messages */
+    uint8_t     address;   /* Default 7-bit I2C address, tried by the boot probe */
+    uint8_t     resultReg; /* Temperature result register */
+    uint8_t     idReg;     /* Device ID register */
+    uint16_t    deviceId;  /* Its value, revision bits 15:12 ignored */
+
+    /* True if something acknowledges the address and result register */
+    bool (*probe)(I2C_Handle i2c, const TempSensor_Driver *driver, uint8_t address);
+    /* True if the device answers with its own ID, in one transfer */
+    bool (*verify)(I2C_Handle i2c, const TempSensor_Driver *driver, uint8_t address);
+    /* Fill in a transaction that reads the result register into rx[2] */
+    void (*prepareRead)(const TempSensor_Driver *driver, uint8_t address,
+                        I2C_Transaction *transaction, uint8_t *tx, uint8_t *rx);
+    /* Result register to 1/128 degree C */
+    TempConv_Q7 (*convert)(uint16_t reg);
+};
+
+extern const TempSensor_Driver *const TempSensor_drivers[];
+extern const uint8_t TempSensor_DRIVER_COUNT;
+
+/*
+ *  ======== TempSensor_convert ========
+ *  Convert a result register read from a sensor using driver.
+ */
+#ifdef TempSensor_FIXED_CONVERT
+#define TempSensor_convert(driver, reg)  TempSensor_FIXED_CONVERT(reg)
+#else
+static inline TempConv_Q7 TempSensor_convert(const TempSensor_Driver *driver, uint16_t reg) {
+    return driver->convert(reg);
+}
+#endif
+
+#endif /* TempSensor_h */
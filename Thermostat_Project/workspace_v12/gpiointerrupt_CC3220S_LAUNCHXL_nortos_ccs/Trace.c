@@ -0,0 +1,114 @@
+/*
+ *  ======== Trace.c ========
+ */
+
+#include "Trace.h"
+#include "TraceEvents.h"
+
+Trace_Buffer Trace_buffer;
+
+#define Trace_INFO(name, args, format)  { TraceEvents_##name, args, #name, format },
+
+/* Decoder metadata only: .log_data is not loaded onto the target */
+__attribute__((section(".log_data"), used))
+const Trace_EventInfo Trace_events[] = {
+    TraceEvents_TABLE(Trace_INFO)
+};
+
+#if CycleCounter_DWT
+
+/*
+ *  ======== counterStart ========
+ *  Leaves the count running if it already is.
+ */
+static void counterStart(void) {
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNT;
+}
+
+#else  /* Host build */
+
+#include <time.h>
+
+/*
+ *  ======== Trace_hostNow ========
+ */
+uint32_t Trace_hostNow(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec) * Trace_COUNTS_PER_US / 1000u);
+}
+
+static void counterStart(void) {
+}
+
+#endif
+
+/*
+ *  ======== Trace_init ========
+ *  Call before any interrupt can log.
+ */
+void Trace_init(void) {
+    counterStart();
+    Trace_buffer.head = 0;
+    Trace_buffer.recordSize = sizeof(Trace_Record);
+    Trace_buffer.capacity = Trace_CAPACITY;
+    Trace_buffer.countsPerUs = Trace_COUNTS_PER_US;
+    Trace_buffer.magic = Trace_MAGIC;
+}
+
+/*
+ *  ======== Trace_read ========
+ *  Copy up to max records from *cursor on, advancing it. Records already
+ *  overwritten are skipped and added to *lost. Interrupts are masked only
+ *  while copying, for at most max records.
+ */
+size_t Trace_read(uint32_t *cursor, Trace_Record *records, size_t max, uint32_t *lost) {
+    uintptr_t key = HwiP_disable();
+    uint32_t head = Trace_buffer.head;
+    size_t count = 0;
+
+    if (head - *cursor > Trace_CAPACITY) {
+        *lost += head - Trace_CAPACITY - *cursor;
+        *cursor = head - Trace_CAPACITY;
+    }
+    while (count < max && *cursor != head) {
+        records[count++] = Trace_buffer.records[*cursor & (Trace_CAPACITY - 1)];
+        (*cursor)++;
+    }
+    HwiP_restore(key);
+    return count;
+}
+
+/*
+ *  ======== Trace_formatLine ========
+ *  Render a record as "!t," and its 16 bytes in hex, little-endian field
+ *  by field as in memory, then "\r\n". buffer must hold Trace_LINE_LEN
+ *  bytes. Returns the length.
+ */
+size_t Trace_formatLine(const Trace_Record *record, char *buffer) {
+    static const char hex[] = "0123456789abcdef";
+    uint32_t fields[4];
+    char *p = buffer;
+    int i, b;
+
+    fields[0] = record->time;
+    fields[1] = record->event | ((uint32_t)record->sequence << 16);
+    fields[2] = record->arg0;
+    fields[3] = record->arg1;
+
+    *p++ = '!';
+    *p++ = 't';
+    *p++ = ',';
+    for (i = 0; i < 4; i++) {
+        for (b = 0; b < 32; b += 8) {
+            *p++ = hex[(fields[i] >> (b + 4)) & 0xF];
+            *p++ = hex[(fields[i] >> b) & 0xF];
+        }
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    *p = '\0';
+    return (size_t)(p - buffer);
+}
@@ -0,0 +1,115 @@
+/*
+ *  ======== Trace.h ========
+ *  Binary trace ring, writable from interrupt and thread context.
+ *
+ *  Trace_log0/1/2() store one fixed 16-byte record, the cycle counter, an
+ *  event id and up to two 32-bit arguments, with interrupts masked for
+ *  the handful of stores it takes; nothing is formatted on the target.
+ *  The ring keeps the last Trace_CAPACITY records.
+ *
+ *  The event ids and their names and printf formats come from the
+ *  project's TraceEvents.h. The formats are kept in the .log_data
+ *  section, which the linker command file places in the off-target
+ *  LOG_DATA region: they are in the .out file for the host decoder but
+ *  take no target memory. The ring itself, Trace_buffer, is ordinary RAM.
+ *
+ *  host/tools/trace_decode.c decodes the ring from a memory dump of
+ *  Trace_buffer, or from the "!t," lines of a UART drain (Trace_read()
+ *  and Trace_formatLine()), naming events from the .out file's .log_data.
+ *
+ *  The cycle counter is the Cortex-M4 DWT CYCCNT on the target, which
+ *  wraps every 53 s at 80 MHz. Host builds use clock_gettime() scaled to
+ *  the same counts.
+ */
+
+#ifndef Trace_h
+#define Trace_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "CycleCounter.h"
+
+#ifndef Trace_ENABLED
+#define Trace_ENABLED       1
+#endif
+
+#ifndef Trace_CAPACITY
+#define Trace_CAPACITY      128  /* Records; must be a power of two */
+#endif
+
+#define Trace_MAGIC         0x31435254u  /* "TRC1" */
+#define Trace_COUNTS_PER_US 80
+#define Trace_NAME_LEN      24
+#define Trace_FORMAT_LEN    36
+#define Trace_LINE_LEN      38  /* "!t," + 32 hex digits + "\r\n" + terminator */
+
+typedef struct {
+    uint32_t time;      /* Cycle counter */
+    uint16_t event;     /* TraceEvents_* id */
+    uint16_t sequence;  /* Low bits of the record number */
+    uint32_t arg0;
+    uint32_t arg1;
+} Trace_Record;
+
+typedef struct {
+    uint32_t          magic;        /* Trace_MAGIC, to find the ring in a dump */
+    uint16_t          recordSize;
+    uint16_t          capacity;
+    uint32_t          countsPerUs;
+    volatile uint32_t head;         /* Records written since Trace_init() */
+    Trace_Record      records[Trace_CAPACITY];
+} Trace_Buffer;
+
+/* One entry of the event table in .log_data; no pointers, so a host tool can read it from the .out */
+typedef struct {
+    uint16_t id;
+    uint16_t args;
+    char     name[Trace_NAME_LEN];
+    char     format[Trace_FORMAT_LEN];
+} Trace_EventInfo;
+
+extern Trace_Buffer Trace_buffer;
+
+extern void Trace_init(void);
+extern size_t Trace_read(uint32_t *cursor, Trace_Record *records, size_t max, uint32_t *lost);
+extern size_t Trace_formatLine(const Trace_Record *record, char *buffer);
+
+#if CycleCounter_DWT
+#define Trace_now()  DWT_CYCCNT
+#else
+extern uint32_t Trace_hostNow(void);
+#define Trace_now()  Trace_hostNow()
+#endif
+
+/*
+ *  ======== Trace_write ========
+ *  Store one record; callable from any context.
+ */
+static inline void Trace_write(uint16_t event, uint32_t arg0, uint32_t arg1) {
+    uintptr_t key = HwiP_disable();
+    uint32_t n = Trace_buffer.head;
+    Trace_Record *r = &Trace_buffer.records[n & (Trace_CAPACITY - 1)];
+
+    r->time = Trace_now();
+    r->event = event;
+    r->sequence = (uint16_t)n;
+    r->arg0 = arg0;
+    r->arg1 = arg1;
+    Trace_buffer.head = n + 1;
+    HwiP_restore(key);
+}
+
+#if Trace_ENABLED
+#define Trace_log0(event)               Trace_write((event), 0, 0)
+#define Trace_log1(event, arg0)         Trace_write((event), (uint32_t)(arg0), 0)
+#define Trace_log2(event, arg0, arg1)   Trace_write((event), (uint32_t)(arg0), (uint32_t)(arg1))
+#else
+#define Trace_log0(event)
+#define Trace_log1(event, arg0)
+#define Trace_log2(event, arg0, arg1)
+#endif
+
+#endif /* Trace_h */
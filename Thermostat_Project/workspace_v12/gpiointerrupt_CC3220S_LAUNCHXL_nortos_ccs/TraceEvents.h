@@ -0,0 +1,28 @@
+/*
+ *  ======== TraceEvents.h ========
+ *  Trace events of the thermostat: X(name, argument count, format).
+ *  Formats take up to two 32-bit arguments with %u, %d or %x conversions.
+ *  Append new events at the end so existing ids keep their meaning.
+ */
+
+#ifndef TraceEvents_h
+#define TraceEvents_h
+
+#define TraceEvents_TABLE(X) \
+    X(BOOT,         1, "boot in %u us") \
+    X(BUTTON,       1, "button %u edge") \
+    X(UART_RX,      1, "uart rx 0x%02x") \
+    X(SENSOR,       2, "zone %u raw 0x%04x") \
+    X(SENSOR_ERROR, 1, "zone %u read failed") \
+    X(SET_POINT,    2, "zone %u set-point %d") \
+    X(HEATER,       2, "zone %u heater %u") \
+    X(MODE,         1, "telemetry mode %u")
+
+#define TraceEvents_ID(name, args, format)  TraceEvents_##name,
+
+enum {
+    TraceEvents_TABLE(TraceEvents_ID)
+    TraceEvents_COUNT
+};
+
+#endif /* TraceEvents_h */
@@ -0,0 +1,146 @@
+/*
+ *  ======== UartTx.c ========
+ *  Ring buffer transmit queue on top of a callback-mode UART.
+ *
+ *  The bytes between tail and head are queued. The first inFlight of them
+ *  belong to the UART_write() the driver is working on, and stay reserved
+ *  until its callback. When that chunk completes, the callback immediately
+ *  starts the next one, which is the other side of the wrap point or the
+ *  bytes that arrived meanwhile. This double-buffers the output: one part
+ *  of the ring is on the wire while the producer fills another. The
+ *  CONFIG_UART_0 instance is not set up for uDMA, so the driver moves each
+ *  chunk through the TX FIFO from its interrupt; the caller still never
+ *  waits.
+ *
+ *  A write that does not fit is dropped whole, never truncated, so framed
+ *  telemetry on the line stays decodable.
+ */
+
+#include <string.h>
+
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "UartTx.h"
+
+static UART_Handle uart;
+static uint8_t ring[UartTx_BUFFER_SIZE];
+static volatile size_t head;      /* Next byte to fill */
+static volatile size_t tail;      /* Oldest queued byte */
+static volatile size_t inFlight;  /* Bytes from tail handed to UART_write() */
+
+static UartTx_Stats stats;
+
+/*
+ *  ======== used ========
+ */
+static size_t used(void) {
+    return (head + UartTx_BUFFER_SIZE - tail) % UartTx_BUFFER_SIZE;
+}
+
+/*
+ *  ======== kick ========
+ *  Start the next contiguous chunk if the driver is idle. Must be called
+ *  with interrupts disabled or from the write callback.
+ */
+static void kick(void) {
+    size_t chunk;
+
+    if (inFlight != 0 || head == tail) {
+        return;
+    }
+    chunk = (head > tail) ? head - tail : UartTx_BUFFER_SIZE - tail;
+    inFlight = chunk;
+    stats.chunks++;
+    if (UART_write(uart, &ring[tail], chunk) == UART_STATUS_ERROR) {
+        inFlight = 0;
+    }
+}
+
+/*
+ *  ======== writeCallback ========
+ *  Runs in interrupt context when a chunk has been sent.
+ */
+static void writeCallback(UART_Handle handle, void *buf, size_t count) {
+    tail = (tail + inFlight) % UartTx_BUFFER_SIZE;
+    inFlight = 0;
+    kick();
+}
+
+/*
+ *  ======== UartTx_open ========
+ *  Opens the UART with params, switched to callback-mode writes. Reads are
+ *  left as configured. Returns the handle, or NULL on failure.
+ */
+UART_Handle UartTx_open(uint_least8_t index, UART_Params *params) {
+    params->writeMode = UART_MODE_CALLBACK;
+    params->writeCallback = writeCallback;
+
+    head = 0;
+    tail = 0;
+    inFlight = 0;
+    uart = UART_open(index, params);
+    return uart;
+}
+
+/*
+ *  ======== UartTx_write ========
+ *  Queue size bytes. Returns size, or 0 if they did not fit and were
+ *  dropped; a zero-length write queues nothing and is not a drop.
+ *  Callable from thread or interrupt context.
+ */
+size_t UartTx_write(const void *data, size_t size) {
+    uintptr_t key;
+    size_t first, queued;
+
+    if (size == 0) {
+        return 0;
+    }
+    key = HwiP_disable();
+    if (size > UartTx_BUFFER_SIZE - 1 - used()) {
+        stats.dropped++;
+        stats.droppedBytes += size;
+        HwiP_restore(key);
+        return 0;
+    }
+
+    first = UartTx_BUFFER_SIZE - head;
+    if (first > size) {
+        first = size;
+    }
+    memcpy(&ring[head], data, first);
+    memcpy(&ring[0], (const uint8_t *)data + first, size - first);
+    head = (head + size) % UartTx_BUFFER_SIZE;
+
+    stats.writes++;
+    stats.bytes += size;
+    queued = used();
+    if (queued > stats.highWater) {
+        stats.highWater = (uint16_t)queued;
+    }
+
+    kick();
+    HwiP_restore(key);
+    return size;
+}
+
+/*
+ *  ======== UartTx_pending ========
+ *  Bytes not yet sent, including the chunk on the wire.
+ */
+size_t UartTx_pending(void) {
+    uintptr_t key = HwiP_disable();
+    size_t pending = used();
+
+    HwiP_restore(key);
+    return pending;
+}
+
+/*
+ *  ======== UartTx_getStats ========
+ */
+void UartTx_getStats(UartTx_Stats *out) {
+    uintptr_t key = HwiP_disable();
+
+    *out = stats;
+    HwiP_restore(key);
+}
@@ -0,0 +1,38 @@
+/*
+ *  ======== UartTx.h ========
+ *  Non-blocking UART transmit queue.
+ *
+ *  UartTx_write() copies the bytes into a RAM ring buffer and returns at
+ *  once. The UART driver, opened in callback mode, drains the ring in the
+ *  background one contiguous chunk at a time, so the caller never waits
+ *  for the wire.
+ */
+
+#ifndef UartTx_h
+#define UartTx_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/UART.h>
+
+#ifndef UartTx_BUFFER_SIZE
+#define UartTx_BUFFER_SIZE  512  /* Ring size in bytes; one byte stays unused */
+#endif
+
+typedef struct {
+    uint32_t writes;        /* UartTx_write() calls accepted */
+    uint32_t bytes;         /* Bytes accepted */
+    uint32_t dropped;       /* UartTx_write() calls rejected for lack of space */
+    uint32_t droppedBytes;  /* Bytes in the rejected calls */
+    uint32_t chunks;        /* UART_write() calls issued to the driver */
+    uint16_t highWater;     /* Most bytes ever queued at once */
+} UartTx_Stats;
+
+extern UART_Handle UartTx_open(uint_least8_t index, UART_Params *params);
+extern size_t UartTx_write(const void *data, size_t size);
+extern size_t UartTx_pending(void);
+extern void UartTx_getStats(UartTx_Stats *stats);
+
+#endif /* UartTx_h */
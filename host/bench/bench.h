@@ -0,0 +1,37 @@
+/*
+ *  ======== bench.h ========
+ *  Timing helpers shared by the host benchmarks.
+ */
+
+#ifndef bench_h
+#define bench_h
+
+#include <stdint.h>
+#include <time.h>
+
+/* Results are folded into this so the compiler cannot drop the work */
+extern volatile uint32_t bench_sink;
+
+/*
+ *  ======== bench_nowNs ========
+ */
+static inline uint64_t bench_nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ *  ======== bench_cycles ========
+ *  CPU timestamp counter where the host has one, else nanoseconds.
+ */
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return bench_nowNs();
+#endif
+}
+
+#endif /* bench_h */
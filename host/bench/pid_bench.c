@@ -0,0 +1,198 @@
+/*
+ *  ======== pid_bench.c ========
+ *  Runs the heater controllers against a simulated room and compares them
+ *  on settling time, overshoot, steady-state error and heater switching:
+ *    bang-bang          the original roomTemperature < setPoint comparison
+ *    bang-bang + median the same comparison on TempFilter output
+ *    pid                Pid_update() driving a Pid_Window, on TempFilter output
+ *
+ *  The room is a two-node thermal model: a radiator that heats and cools
+ *  with its own time constant, and the room air losing heat to the outside.
+ *  The sensor adds noise and quantizes to the TMP006 LSB. Each controller
+ *  runs at the 500 ms heater task period for six simulated hours, with the
+ *  set-point raised by 2 C after three hours. The cost per control tick is
+ *  timed afterwards by replaying the recorded sensor readings.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "Pid.h"
+#include "TempFilter.h"
+
+#define TICK_MS          500
+#define HOURS            6
+#define TICKS            (HOURS * 3600 * 1000 / TICK_MS)
+#define STEP_TICK        (TICKS / 2)
+#define BAND_C           0.25     /* Settled when within this of the set-point */
+
+/* Room model */
+#define OUTSIDE_C        10.0
+#define START_C          15.0
+#define ROOM_J_PER_K     1.0e6
+#define LOSS_W_PER_K     100.0
+#define HEATER_W         3000.0
+#define RADIATOR_TAU_S   120.0
+#define NOISE_C          0.10
+
+/* Controller tuning */
+#define KP               Pid_GAIN(2000)  /* Full duty at 0.5 C below the set-point */
+#define KI               Pid_GAIN(1)
+#define KD               Pid_GAIN(0)     /* PI: the sensor noise makes D switch the window */
+#define WINDOW_TICKS     120             /* 60 s heater window, half the radiator lag */
+#define REPLAYS          20
+
+volatile uint32_t bench_sink;
+
+static TempConv_Q7 readings[TICKS];
+
+typedef enum {
+    CONTROL_BANG_BANG,
+    CONTROL_BANG_BANG_MEDIAN,
+    CONTROL_PID
+} Control;
+
+typedef struct {
+    double settleS[2];     /* Time to stay inside the band, for each set-point phase */
+    double overshootC[2];  /* Largest excursion above the set-point */
+    double meanErrorC;     /* Mean |error| over the last hour of each phase */
+    uint32_t switches;
+    double energyKWh;
+    double nsPerUpdate;
+} Result;
+
+/*
+ *  ======== noise ========
+ *  Roughly Gaussian, from the sum of four uniform samples.
+ */
+static double noise(uint32_t *state) {
+    double sum = 0.0;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        *state = *state * 1664525u + 1013904223u;
+        sum += (*state >> 8) / 16777216.0 - 0.5;
+    }
+    return sum * NOISE_C * 1.73;
+}
+
+/*
+ *  ======== step ========
+ *  One heater decision, as heaterTask would make it.
+ */
+static bool step(Control control, Pid *pid, Pid_Window *window, TempFilter *filter,
+                 int32_t setPoint, TempConv_Q7 measured) {
+    switch (control) {
+        case CONTROL_BANG_BANG:
+            return measured < TempConv_fromDegrees(setPoint);
+        case CONTROL_BANG_BANG_MEDIAN:
+            return TempFilter_update(filter, measured) < TempConv_fromDegrees(setPoint);
+        case CONTROL_PID:
+            break;
+    }
+    return Pid_windowStep(window, Pid_update(pid, TempConv_fromDegrees(setPoint),
+                                             TempFilter_update(filter, measured)));
+}
+
+/*
+ *  ======== simulate ========
+ */
+static void simulate(Control control, Result *result) {
+    Pid pid;
+    Pid_Window window;
+    TempFilter filter;
+    double room = START_C, radiator = 0.0, dt = TICK_MS / 1000.0;
+    double errorSum = 0.0;
+    uint32_t errorCount = 0, state = 2024, tick, sink = 0;
+    uint64_t start;
+    int32_t setPoint = 21;
+    uint32_t settledSince = 0;
+    bool heater = false, on;
+    int phase, replay;
+
+    Pid_init(&pid, KP, KI, KD, TICK_MS);
+    Pid_windowInit(&window, WINDOW_TICKS);
+    TempFilter_init(&filter, TempFilter_KIND_MEDIAN);
+    result->switches = 0;
+    result->energyKWh = 0.0;
+
+    for (tick = 0; tick < TICKS; tick++) {
+        TempConv_Q7 measured;
+        double error;
+
+        phase = (tick >= STEP_TICK);
+        if (tick == STEP_TICK) {
+            setPoint += 2;
+            result->settleS[0] = settledSince * dt;
+            settledSince = tick;
+            result->overshootC[1] = 0.0;
+        } else if (tick == 0) {
+            result->overshootC[0] = 0.0;
+        }
+
+        /* Sensor: noise, then the 1/128 C register LSB */
+        measured = (TempConv_Q7)lround((room + noise(&state)) * TempConv_Q7_ONE);
+        readings[tick] = measured;
+
+        on = step(control, &pid, &window, &filter, setPoint, measured);
+
+        if (on != heater) {
+            heater = on;
+            result->switches++;
+        }
+
+        /* Plant, one tick */
+        radiator += (((heater ? HEATER_W : 0.0) - radiator) / RADIATOR_TAU_S) * dt;
+        room += ((radiator - LOSS_W_PER_K * (room - OUTSIDE_C)) / ROOM_J_PER_K) * dt;
+        result->energyKWh += radiator * dt / 3.6e6;
+
+        error = room - setPoint;
+        if (fabs(error) > BAND_C) {
+            settledSince = tick + 1;
+        }
+        if (error > result->overshootC[phase]) {
+            result->overshootC[phase] = error;
+        }
+        if ((tick % STEP_TICK) >= STEP_TICK - 3600 * 1000 / TICK_MS) {
+            errorSum += fabs(error);
+            errorCount++;
+        }
+    }
+    result->settleS[1] = (settledSince - STEP_TICK) * dt;
+    result->meanErrorC = errorSum / errorCount;
+
+    start = bench_nowNs();
+    for (replay = 0; replay < REPLAYS; replay++) {
+        Pid_init(&pid, KP, KI, KD, TICK_MS);
+        Pid_windowInit(&window, WINDOW_TICKS);
+        TempFilter_init(&filter, TempFilter_KIND_MEDIAN);
+        for (tick = 0; tick < TICKS; tick++) {
+            sink += step(control, &pid, &window, &filter, tick < STEP_TICK ? 21 : 23, readings[tick]);
+        }
+    }
+    result->nsPerUpdate = (double)(bench_nowNs() - start) / ((double)REPLAYS * TICKS);
+    bench_sink = sink;
+}
+
+int main(void) {
+    static const char *names[] = { "bang-bang", "bang-bang+median", "pid+median" };
+    Result result;
+    int c;
+
+    printf("pid: room %.0f C start, %.0f C outside, %.0f W heater, %.0f s radiator lag, "
+           "%.2f C sensor noise\n", START_C, OUTSIDE_C, HEATER_W, RADIATOR_TAU_S, NOISE_C);
+    printf("     %d h at %d ms per control tick; set-point 21 C, then 23 C at %d h\n",
+           HOURS, TICK_MS, HOURS / 2);
+    printf("  %-17s %9s %9s %10s %10s %9s %8s %8s\n", "controller", "settle21", "settle23",
+           "overshoot", "mean|err|", "switches", "kWh", "ns/tick");
+    for (c = CONTROL_BANG_BANG; c <= CONTROL_PID; c++) {
+        simulate((Control)c, &result);
+        printf("  %-17s %8.0fs %8.0fs %9.2fC %9.3fC %9u %8.2f %8.1f\n", names[c],
+               result.settleS[0], result.settleS[1],
+               result.overshootC[0] > result.overshootC[1] ? result.overshootC[0] : result.overshootC[1],
+               result.meanErrorC, result.switches, result.energyKWh, result.nsPerUpdate);
+    }
+    return 0;
+}
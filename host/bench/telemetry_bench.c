@@ -0,0 +1,84 @@
+/*
+ *  ======== telemetry_bench.c ========
+ *  Compares the telemetry encodings on a day of one-zone records at the
+ *  1 s report period: bytes per record, encode cost, and how many records
+ *  per second fit on the 115200 baud link (8N1, ten bit times per byte).
+ *
+ *  The room follows a slow daily swing with sensor noise at the TMP006
+ *  LSB (1/32 C), already smoothed as TempFilter would; the heater cycles
+ *  every few minutes and the set-point changes twice a day.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "bench.h"
+#include "Telemetry.h"
+
+#define RECORDS     86400
+#define BAUD        115200
+#define ROUNDS      10
+
+volatile uint32_t bench_sink;
+
+static Telemetry_Record records[RECORDS];
+
+/*
+ *  ======== makeTrace ========
+ */
+static void makeTrace(void) {
+    uint32_t state = 1;
+    double temp;
+    int i;
+
+    for (i = 0; i < RECORDS; i++) {
+        state = state * 1664525u + 1013904223u;
+        temp = 21.0 + 1.5 * sin(i * 2.0 * M_PI / RECORDS) + ((int)(state >> 30) - 1.5) / 32.0;
+        records[i].roomTemperature = (TempConv_Q7)lround(temp * 32.0) * 4;
+        records[i].setPoint = (i < RECORDS / 4 || i >= RECORDS * 3 / 4) ? 19 : 22;
+        records[i].heaterOn = (i / 240) % 3 == 0;
+        records[i].timeCounter = (uint32_t)i;
+        records[i].zone = 0;
+    }
+}
+
+int main(void) {
+    static const char *names[] = { "ascii", "binary", "delta" };
+    uint8_t buffer[Telemetry_MAX_LEN];
+    uint64_t bytes, start, ns;
+    uint32_t sink = 0;
+    double asciiBytes = 0.0, perRecord;
+    int mode, round, i;
+
+    makeTrace();
+    printf("telemetry: %d records, one zone, keyframe every %d records in delta mode\n",
+           RECORDS, Telemetry_KEYFRAME_INTERVAL);
+    printf("  %-8s %12s %10s %12s %8s\n", "mode", "bytes/rec", "ns/rec", "rec/s@115k", "vs ascii");
+
+    for (mode = Telemetry_MODE_ASCII; mode <= Telemetry_MODE_DELTA; mode++) {
+        Telemetry_setMode((Telemetry_Mode)mode);
+        bytes = 0;
+        for (i = 0; i < RECORDS; i++) {
+            bytes += Telemetry_encode(&records[i], buffer, sizeof(buffer));
+        }
+
+        start = bench_nowNs();
+        for (round = 0; round < ROUNDS; round++) {
+            Telemetry_setMode(Telemetry_MODE_ASCII);
+            Telemetry_setMode((Telemetry_Mode)mode);  /* Same keyframe phase every round */
+            for (i = 0; i < RECORDS; i++) {
+                sink += (uint32_t)Telemetry_encode(&records[i], buffer, sizeof(buffer));
+            }
+        }
+        ns = bench_nowNs() - start;
+
+        perRecord = (double)bytes / RECORDS;
+        if (mode == Telemetry_MODE_ASCII) {
+            asciiBytes = perRecord;
+        }
+        printf("  %-8s %12.2f %10.1f %12.0f %7.1fx\n", names[mode], perRecord,
+               (double)ns / ((double)ROUNDS * RECORDS), BAUD / 10.0 / perRecord, asciiBytes / perRecord);
+    }
+    bench_sink = sink;
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ *  ======== tempconv_bench.c ========
+ *  Compares the original readTemp() conversion, a float multiply on an
+ *  int16_t, with TempConv_fromTmp006() over every possible register value:
+ *  cost per sample and error against the exact temperature.
+ *
+ *  The host has a hardware FPU, so the float path is cheaper here than the
+ *  soft-float routines it pulls in on the CC3220; the accuracy numbers
+ *  carry over unchanged.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench.h"
+#include "TempConv.h"
+
+#define ROUNDS  200
+
+volatile uint32_t bench_sink;
+
+/*
+ *  ======== legacyConvert ========
+ *  The conversion readTemp() used before TempConv, kept verbatim.
+ */
+static int16_t legacyConvert(uint16_t reg) {
+    uint8_t rxBuffer[2] = { (uint8_t)(reg >> 8), (uint8_t)reg };
+    int16_t temperature;
+
+    temperature = (rxBuffer[0] << 8) | (rxBuffer[1]);
+    temperature *= 0.0078125;  /* Convert raw data to temperature value */
+
+    if (rxBuffer[0] & 0x80) {
+        temperature |= 0xF000;  /* Adjust for negative temperatures */
+    }
+    return temperature;
+}
+
+int main(void) {
+    uint64_t start, legacyNs, fixedNs;
+    uint32_t sink = 0, legacyWrong = 0;
+    double legacyMaxErr = 0.0, fixedMaxErr = 0.0;
+    int round;
+    uint32_t reg;
+
+    start = bench_nowNs();
+    for (round = 0; round < ROUNDS; round++) {
+        for (reg = 0; reg <= 0xFFFF; reg++) {
+            sink += (uint32_t)legacyConvert((uint16_t)reg);
+        }
+    }
+    legacyNs = bench_nowNs() - start;
+
+    start = bench_nowNs();
+    for (round = 0; round < ROUNDS; round++) {
+        for (reg = 0; reg <= 0xFFFF; reg++) {
+            sink += (uint32_t)TempConv_fromTmp006((uint16_t)reg);
+        }
+    }
+    fixedNs = bench_nowNs() - start;
+    bench_sink = sink;
+
+    for (reg = 0; reg <= 0xFFFF; reg++) {
+        double exact = (int16_t)(reg & 0xFFFC) / 128.0;
+        double legacyErr = abs((int)legacyConvert((uint16_t)reg) * 128 - (int16_t)(reg & 0xFFFC)) / 128.0;
+        double fixedErr = TempConv_fromTmp006((uint16_t)reg) / 128.0 - exact;
+
+        if (legacyErr > legacyMaxErr) {
+            legacyMaxErr = legacyErr;
+        }
+        if (legacyErr >= 1.0) {
+            legacyWrong++;
+        }
+        if (fixedErr < 0) {
+            fixedErr = -fixedErr;
+        }
+        if (fixedErr > fixedMaxErr) {
+            fixedMaxErr = fixedErr;
+        }
+    }
+
+    printf("tempconv: %u samples per path\n", ROUNDS * 65536u);
+    printf("  legacy float  %6.2f ns/sample, max error %8.4f C, %u of 65536 codes off by >= 1 C\n",
+           (double)legacyNs / (ROUNDS * 65536.0), legacyMaxErr, legacyWrong);
+    printf("  fixed Q7      %6.2f ns/sample, max error %8.4f C, resolution %.7f C\n",
+           (double)fixedNs / (ROUNDS * 65536.0), fixedMaxErr, 1.0 / TempConv_Q7_ONE);
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ *  ======== tempfilter_bench.c ========
+ *  Cost per sample of each TempFilter kind, and how much each one quiets
+ *  the heater decision on a noisy reading that sits on the set-point.
+ *
+ *  The input is 22 C with +/-0.25 C of sensor noise and an occasional
+ *  2 C spike. A full sort of the window per sample is timed alongside the
+ *  sliding median and used to check its output.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "TempFilter.h"
+
+#define SAMPLES   (1u << 20)
+#define ROUNDS    20
+
+volatile uint32_t bench_sink;
+
+static TempConv_Q7 input[SAMPLES];
+
+/*
+ *  ======== makeInput ========
+ */
+static void makeInput(void) {
+    uint32_t state = 12345;
+    uint32_t i;
+
+    for (i = 0; i < SAMPLES; i++) {
+        state = state * 1664525u + 1013904223u;
+        input[i] = TempConv_fromDegrees(22) + (int32_t)((state >> 16) % 65) - 32;
+        if ((state >> 8) % 97 == 0) {
+            input[i] += TempConv_fromDegrees(2);
+        }
+    }
+}
+
+/*
+ *  ======== sortedMedian ========
+ *  Reference: copy the window and insertion-sort it for every sample.
+ */
+static TempConv_Q7 sortedMedian(TempFilter *filter, TempConv_Q7 sample) {
+    TempConv_Q7 window[TempFilter_WINDOW];
+    int i, j, n;
+
+    filter->ring[filter->head] = sample;
+    filter->head = (filter->head + 1) % TempFilter_WINDOW;
+    if (filter->count < TempFilter_WINDOW) {
+        filter->count++;
+    }
+    n = filter->count;
+    memcpy(window, filter->ring, sizeof(window));
+    for (i = 1; i < n; i++) {
+        TempConv_Q7 v = window[i];
+
+        for (j = i; j > 0 && window[j - 1] > v; j--) {
+            window[j] = window[j - 1];
+        }
+        window[j] = v;
+    }
+    if (n & 1) {
+        return window[n / 2];
+    }
+    n = window[n / 2 - 1] + window[n / 2];
+    return (n >= 0) ? (n + 1) / 2 : (n - 1) / 2;  /* Same rounding as TempFilter */
+}
+
+typedef TempConv_Q7 (*FilterFxn)(TempFilter *filter, TempConv_Q7 sample);
+
+static TempConv_Q7 passThrough(TempFilter *filter, TempConv_Q7 sample) {
+    (void)filter;
+    return sample;
+}
+
+/*
+ *  ======== run ========
+ */
+static void run(const char *name, FilterFxn fxn) {
+    TempFilter filter;
+    TempConv_Q7 setPoint = TempConv_fromDegrees(22);
+    uint64_t startNs, startCycles, ns = 0, cycles = 0;
+    uint32_t sink = 0, switches = 0;
+    bool heater = false;
+    uint32_t i;
+    int round;
+
+    for (round = 0; round < ROUNDS; round++) {
+        TempFilter_init(&filter, TempFilter_KIND_NONE);
+        startNs = bench_nowNs();
+        startCycles = bench_cycles();
+        for (i = 0; i < SAMPLES; i++) {
+            sink += (uint32_t)fxn(&filter, input[i]);
+        }
+        cycles += bench_cycles() - startCycles;
+        ns += bench_nowNs() - startNs;
+    }
+    bench_sink = sink;
+
+    TempFilter_init(&filter, TempFilter_KIND_NONE);
+    for (i = 0; i < SAMPLES; i++) {
+        bool on = fxn(&filter, input[i]) < setPoint;
+
+        if (on != heater) {
+            heater = on;
+            switches++;
+        }
+    }
+
+    printf("  %-14s %6.2f ns/sample %7.2f cycles/sample, heater switches %6u\n", name,
+           (double)ns / ((double)ROUNDS * SAMPLES), (double)cycles / ((double)ROUNDS * SAMPLES), switches);
+}
+
+int main(void) {
+    TempFilter a, b;
+    uint32_t i, mismatches = 0;
+
+    makeInput();
+
+    TempFilter_init(&a, TempFilter_KIND_MEDIAN);
+    TempFilter_init(&b, TempFilter_KIND_MEDIAN);
+    for (i = 0; i < SAMPLES; i++) {
+        if (TempFilter_median(&a, input[i]) != sortedMedian(&b, input[i])) {
+            mismatches++;
+        }
+    }
+
+    printf("tempfilter: window %u, ema shift %u, %u samples x %u rounds\n",
+           TempFilter_WINDOW, TempFilter_EMA_SHIFT, SAMPLES, ROUNDS);
+    run("none", passThrough);
+    run("mean", TempFilter_mean);
+    run("ema", TempFilter_ema);
+    run("median", TempFilter_median);
+    run("median (sort)", sortedMedian);
+    printf("  sliding median disagrees with full sort on %u samples\n", mismatches);
+    return mismatches != 0;
+}
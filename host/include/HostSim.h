@@ -0,0 +1,111 @@
+/*
+ *  ======== HostSim.h ========
+ *  Core of the Linux stand-in for the SimpleLink drivers.
+ *
+ *  The host build runs a mainThread as an ordinary single-threaded process.
+ *  Hardware interrupts are modelled with POSIX real-time signals delivered to
+ *  that thread, so a timer or button callback preempts the main loop exactly
+ *  like an ISR would on the CC3220. Time is kept on a virtual clock that runs
+ *  HOST_TIME_SCALE times faster than the wall clock.
+ *
+ *  Environment variables read by Board_init():
+ *    HOST_TIME_SCALE    virtual seconds per wall second (default 1)
+ *    HOST_RUN_SECONDS   stop after this many virtual seconds (default 0 = run forever)
+ *    HOST_BUTTONS       button presses, "index@seconds[:hold][,...]" (hold default 0.15 s)
+ *    HOST_BOUNCE        extra contact bounces on every button press and release (default 3)
+ *    HOST_I2C_SENSOR    I2C addresses of the simulated TMP sensors, "a[,a...]" (default 0x41)
+ *    HOST_TEMP_MC       their temperatures in milli-degrees C, "t[,t...]" (default 22000)
+ *    HOST_MODEL_BUS     1 = blocking UART/I2C calls wait for the wire time (default 1)
+ *    HOST_TRACE         1 = log GPIO/PWM/Timer activity to stderr (default 0)
+ *    HOST_FS_DIR        directory holding the serial flash files (default hostfs)
+ */
+
+#ifndef HostSim_h
+#define HostSim_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Clock frequency seen by Timer_PERIOD_COUNTS and Timer_getCount() */
+#define HostSim_CPU_FREQ_HZ     80000000u
+
+/* Interrupt sources, used to keep separate ISR cost statistics */
+typedef enum {
+    HostSim_IRQ_TIMER,
+    HostSim_IRQ_GPIO,
+    HostSim_IRQ_I2C,
+    HostSim_IRQ_UART,
+    HostSim_IRQ_COUNT
+} HostSim_IrqSource;
+
+typedef void (*HostSim_IrqFxn)(uintptr_t arg);
+
+/* One simulated interrupt line backed by a POSIX timer */
+typedef struct {
+    HostSim_IrqFxn    fxn;
+    uintptr_t         arg;
+    HostSim_IrqSource source;
+    timer_t           timer;
+    bool              created;
+} HostSim_Irq;
+
+/* Accumulated cost of all invocations from one interrupt source */
+typedef struct {
+    uint32_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+} HostSim_IsrStats;
+
+/* Driver activity counters, printed in the end-of-run report */
+typedef struct {
+    uint32_t uartWrites;
+    uint64_t uartBytesOut;
+    uint64_t uartWireUs;
+    uint32_t uartReads;
+    uint32_t i2cTransfers;
+    uint32_t i2cNacks;
+    uint64_t i2cBusUs;
+    uint32_t gpioWrites;
+    uint32_t gpioEdges;         /* Input edges on the simulated buttons */
+    uint32_t gpioEdgesMasked;   /* Edges that found the pin interrupt disabled */
+    uint32_t pwmDutyChanges;
+    uint32_t wfiCount;
+    uint64_t idleUs;
+    uint64_t wfiSinceUs;    /* Start of the WFI in progress, 0 when awake */
+} HostSim_Counters;
+
+extern HostSim_Counters HostSim_counters;
+extern HostSim_IsrStats HostSim_isrStats[HostSim_IRQ_COUNT];
+
+void     HostSim_init(void);
+uint64_t HostSim_nowUs(void);
+void     HostSim_sleepUs(uint64_t us);
+bool     HostSim_modelBus(void);
+bool     HostSim_trace(void);
+
+uint64_t HostSim_envU64(const char *name, uint64_t defaultValue);
+double   HostSim_envDouble(const char *name, double defaultValue);
+
+void HostSim_irqCreate(HostSim_Irq *irq, HostSim_IrqSource source,
+                       HostSim_IrqFxn fxn, uintptr_t arg);
+void HostSim_irqArm(HostSim_Irq *irq, uint64_t delayUs, uint64_t intervalUs);
+void HostSim_irqDisarm(HostSim_Irq *irq);
+void HostSim_irqWatchFd(HostSim_Irq *irq, int fd);
+
+void HostSim_report(void);
+
+/* Hooks implemented by the individual driver stand-ins */
+void GPIO_hostInject(uint_least8_t index, uint_fast8_t value);
+void GPIO_hostSchedule(const char *spec);
+void I2C_hostConfigure(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -0,0 +1,29 @@
+/*
+ *  ======== NoRTOS.h ========
+ *  Host stand-in for the SimpleLink NoRTOS kernel header.
+ */
+
+#ifndef ti_dpl_NoRTOS__include
+#define ti_dpl_NoRTOS__include
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    void      (*idleCallback)(void);
+    uint32_t  clockTickPeriod;
+    uint32_t  swiIntNum;
+} NoRTOS_Config;
+
+extern void NoRTOS_getConfig(NoRTOS_Config *cfg);
+extern void NoRTOS_setConfig(NoRTOS_Config *cfg);
+extern void NoRTOS_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ti_dpl_NoRTOS__include */
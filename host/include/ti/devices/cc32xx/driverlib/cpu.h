@@ -0,0 +1,22 @@
+/*
+ *  ======== cpu.h ========
+ *  Host stand-in for the CC32xx driverlib CPU intrinsics.
+ *  CPUwfi() suspends the process until the next HostSim interrupt.
+ */
+
+#ifndef __CPU_H__
+#define __CPU_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern unsigned long CPUcpsid(void);
+extern unsigned long CPUcpsie(void);
+extern void CPUwfi(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CPU_H__ */
@@ -0,0 +1,21 @@
+/*
+ *  ======== prcm.h ========
+ *  Host stand-in for the CC32xx driverlib PRCM slow clock counter, which
+ *  runs at 32768 Hz on the HostSim virtual clock.
+ */
+
+#ifndef __PRCM_H__
+#define __PRCM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern unsigned long long PRCMSlowClkCtrGet(void);
+extern unsigned long long PRCMSlowClkCtrFastGet(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PRCM_H__ */
@@ -0,0 +1,11 @@
+/*
+ *  ======== hw_types.h ========
+ *  Host stand-in for the CC32xx driverlib common types.
+ */
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+typedef unsigned char tBoolean;
+
+#endif /* __HW_TYPES_H__ */
@@ -0,0 +1,11 @@
+/*
+ *  ======== Board.h ========
+ *  Host stand-in for <ti/drivers/Board.h>.
+ */
+
+#ifndef ti_drivers_Board__include
+#define ti_drivers_Board__include
+
+#include "ti_drivers_config.h"
+
+#endif /* ti_drivers_Board__include */
@@ -0,0 +1,68 @@
+/*
+ *  ======== GPIO.h ========
+ *  Host stand-in for <ti/drivers/GPIO.h>. Pins are plain state in memory;
+ *  interrupts are raised by HOST_BUTTONS or GPIO_hostInject().
+ */
+
+#ifndef ti_drivers_GPIO__include
+#define ti_drivers_GPIO__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t GPIO_PinConfig;
+
+typedef void (*GPIO_CallbackFxn)(uint_least8_t index);
+
+#define GPIO_STATUS_RESERVED        (-32)
+#define GPIO_STATUS_SUCCESS         (0)
+#define GPIO_STATUS_ERROR           (-1)
+
+#define GPIO_CFG_OUTPUT             (0x00000000)
+#define GPIO_CFG_OUT_STD            (0x00000000)
+#define GPIO_CFG_OUT_OD_NOPULL      (0x00020000)
+#define GPIO_CFG_OUT_OD_PU          (0x00040000)
+#define GPIO_CFG_OUT_OD_PD          (0x00060000)
+#define GPIO_CFG_OUT_STR_LOW        (0x00000000)
+#define GPIO_CFG_OUT_STR_MED        (0x00010000)
+#define GPIO_CFG_OUT_STR_HIGH       (0x00020000)
+#define GPIO_CFG_OUT_HIGH           (0x00080000)
+#define GPIO_CFG_OUT_LOW            (0x00000000)
+
+#define GPIO_CFG_INPUT              (0x01000000)
+#define GPIO_CFG_IN_NOPULL          (0x01000000)
+#define GPIO_CFG_IN_PU              (0x01020000)
+#define GPIO_CFG_IN_PD              (0x01040000)
+
+#define GPIO_CFG_IN_INT_NONE        (0x00000000)
+#define GPIO_CFG_IN_INT_FALLING     (0x00100000)
+#define GPIO_CFG_IN_INT_RISING      (0x00200000)
+#define GPIO_CFG_IN_INT_BOTH_EDGES  (0x00300000)
+#define GPIO_CFG_IN_INT_LOW         (0x00400000)
+#define GPIO_CFG_IN_INT_HIGH        (0x00500000)
+#define GPIO_CFG_INT_MASK           (0x00700000)
+
+#define GPIO_CFG_INT_DISABLE        (0x10000000)
+#define GPIO_DO_NOT_CONFIG          (0x40000000)
+
+extern void GPIO_clearInt(uint_least8_t index);
+extern void GPIO_disableInt(uint_least8_t index);
+extern void GPIO_enableInt(uint_least8_t index);
+extern void GPIO_getConfig(uint_least8_t index, GPIO_PinConfig *pinConfig);
+extern void GPIO_init(void);
+extern uint_fast8_t GPIO_read(uint_least8_t index);
+extern void GPIO_setCallback(uint_least8_t index, GPIO_CallbackFxn callback);
+extern int_fast16_t GPIO_setConfig(uint_least8_t index, GPIO_PinConfig pinConfig);
+extern void GPIO_toggle(uint_least8_t index);
+extern void GPIO_write(uint_least8_t index, unsigned int value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ti_drivers_GPIO__include */
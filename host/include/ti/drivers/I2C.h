@@ -0,0 +1,77 @@
+/*
+ *  ======== I2C.h ========
+ *  Host stand-in for <ti/drivers/I2C.h>. The bus carries one simulated TMP
+ *  temperature sensor, selected with HOST_I2C_SENSOR.
+ */
+
+#ifndef ti_drivers_I2C__include
+#define ti_drivers_I2C__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define I2C_CMD_RESERVED            (32)
+#define I2C_STATUS_RESERVED         (-32)
+#define I2C_STATUS_SUCCESS          (0)
+#define I2C_STATUS_ERROR            (-1)
+#define I2C_STATUS_UNDEFINEDCMD     (-2)
+
+typedef struct I2C_Config_ *I2C_Handle;
+
+typedef struct {
+    void         *writeBuf;
+    size_t        writeCount;
+    void         *readBuf;
+    size_t        readCount;
+    uint_least8_t slaveAddress;
+    void         *arg;
+    void         *nextPtr;
+} I2C_Transaction;
+
+typedef enum {
+    I2C_MODE_BLOCKING,
+    I2C_MODE_CALLBACK
+} I2C_TransferMode;
+
+typedef void (*I2C_CallbackFxn)(I2C_Handle handle, I2C_Transaction *transaction,
+                                bool transferStatus);
+
+typedef enum {
+    I2C_100kHz  = 0,
+    I2C_400kHz  = 1,
+    I2C_1000kHz = 2,
+    I2C_3330kHz = 3,
+    I2C_3400kHz = 4
+} I2C_BitRate;
+
+typedef struct {
+    I2C_TransferMode transferMode;
+    I2C_CallbackFxn  transferCallbackFxn;
+    I2C_BitRate      bitRate;
+    void            *custom;
+} I2C_Params;
+
+typedef struct I2C_Config_ {
+    void       *fxnTablePtr;
+    void       *object;
+    void const *hwAttrs;
+} I2C_Config;
+
+extern void I2C_cancel(I2C_Handle handle);
+extern void I2C_close(I2C_Handle handle);
+extern int_fast16_t I2C_control(I2C_Handle handle, uint_fast16_t cmd, void *controlArg);
+extern void I2C_init(void);
+extern I2C_Handle I2C_open(uint_least8_t index, I2C_Params *params);
+extern void I2C_Params_init(I2C_Params *params);
+extern bool I2C_transfer(I2C_Handle handle, I2C_Transaction *transaction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ti_drivers_I2C__include */
@@ -0,0 +1,76 @@
+/*
+ *  ======== PWM.h ========
+ *  Host stand-in for <ti/drivers/PWM.h>. Duty changes are counted and, with
+ *  HOST_TRACE=1, logged to stderr.
+ */
+
+#ifndef ti_drivers_PWM__include
+#define ti_drivers_PWM__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PWM_CMD_RESERVED            (32)
+#define PWM_STATUS_RESERVED         (-32)
+#define PWM_STATUS_SUCCESS          (0)
+#define PWM_STATUS_ERROR            (-1)
+#define PWM_STATUS_UNDEFINEDCMD     (-2)
+#define PWM_STATUS_INVALID_PERIOD   (-3)
+#define PWM_STATUS_INVALID_DUTY     (-4)
+
+#define PWM_DUTY_FRACTION_MAX       ((uint32_t) ~0)
+
+typedef struct PWM_Config_ *PWM_Handle;
+
+typedef enum {
+    PWM_PERIOD_US,
+    PWM_PERIOD_HZ,
+    PWM_PERIOD_COUNTS
+} PWM_Period_Units;
+
+typedef enum {
+    PWM_DUTY_US,
+    PWM_DUTY_FRACTION,
+    PWM_DUTY_COUNTS
+} PWM_Duty_Units;
+
+typedef enum {
+    PWM_IDLE_LOW = 0,
+    PWM_IDLE_HIGH = 1
+} PWM_IdleLevel;
+
+typedef struct {
+    PWM_Period_Units periodUnits;
+    uint32_t         periodValue;
+    PWM_Duty_Units   dutyUnits;
+    uint32_t         dutyValue;
+    PWM_IdleLevel    idleLevel;
+    void            *custom;
+} PWM_Params;
+
+typedef struct PWM_Config_ {
+    void       *fxnTablePtr;
+    void       *object;
+    void const *hwAttrs;
+} PWM_Config;
+
+extern void PWM_close(PWM_Handle handle);
+extern int_fast16_t PWM_control(PWM_Handle handle, uint_fast16_t cmd, void *arg);
+extern void PWM_init(void);
+extern PWM_Handle PWM_open(uint_least8_t index, PWM_Params *params);
+extern void PWM_Params_init(PWM_Params *params);
+extern int_fast16_t PWM_setDuty(PWM_Handle handle, uint32_t duty);
+extern int_fast16_t PWM_setPeriod(PWM_Handle handle, uint32_t period);
+extern void PWM_start(PWM_Handle handle);
+extern void PWM_stop(PWM_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ti_drivers_PWM__include */
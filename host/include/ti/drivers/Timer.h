@@ -0,0 +1,68 @@
+/*
+ *  ======== Timer.h ========
+ *  Host stand-in for <ti/drivers/Timer.h>. Each timer is a POSIX timer on
+ *  the HostSim virtual clock; callbacks run in simulated interrupt context.
+ */
+
+#ifndef ti_drivers_Timer__include
+#define ti_drivers_Timer__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define Timer_CMD_RESERVED          (32)
+#define Timer_STATUS_RESERVED       (-32)
+#define Timer_STATUS_SUCCESS        (0)
+#define Timer_STATUS_ERROR          (-1)
+#define Timer_STATUS_UNDEFINEDCMD   (-2)
+
+typedef struct Timer_Config_ *Timer_Handle;
+
+typedef enum {
+    Timer_ONESHOT_BLOCKING,
+    Timer_ONESHOT_CALLBACK,
+    Timer_CONTINUOUS_CALLBACK,
+    Timer_FREE_RUNNING
+} Timer_Mode;
+
+typedef enum {
+    Timer_PERIOD_US,
+    Timer_PERIOD_HZ,
+    Timer_PERIOD_COUNTS
+} Timer_PeriodUnits;
+
+typedef void (*Timer_CallBackFxn)(Timer_Handle handle, int_fast16_t status);
+
+typedef struct {
+    Timer_Mode         timerMode;
+    Timer_PeriodUnits  periodUnits;
+    Timer_CallBackFxn  timerCallback;
+    uint32_t           period;
+} Timer_Params;
+
+typedef struct Timer_Config_ {
+    void       *fxnTablePtr;
+    void       *object;
+    void const *hwAttrs;
+} Timer_Config;
+
+extern void Timer_close(Timer_Handle handle);
+extern int_fast16_t Timer_control(Timer_Handle handle, uint_fast16_t cmd, void *arg);
+extern uint32_t Timer_getCount(Timer_Handle handle);
+extern void Timer_init(void);
+extern Timer_Handle Timer_open(uint_least8_t index, Timer_Params *params);
+extern int32_t Timer_setPeriod(Timer_Handle handle, Timer_PeriodUnits periodUnits, uint32_t period);
+extern void Timer_Params_init(Timer_Params *params);
+extern int32_t Timer_start(Timer_Handle handle);
+extern void Timer_stop(Timer_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ti_drivers_Timer__include */
@@ -0,0 +1,110 @@
+/*
+ *  ======== UART.h ========
+ *  Host stand-in for <ti/drivers/UART.h>. CONFIG_UART_0 writes to stdout and
+ *  reads from stdin; blocking writes take the wire time at the baud rate.
+ */
+
+#ifndef ti_drivers_UART__include
+#define ti_drivers_UART__include
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UART_CMD_RESERVED           (32)
+#define UART_STATUS_RESERVED        (-32)
+#define UART_STATUS_SUCCESS         (0)
+#define UART_STATUS_ERROR           (-1)
+#define UART_STATUS_UNDEFINEDCMD    (-2)
+
+#define UART_ERROR                  (UART_STATUS_ERROR)
+#define UART_WAIT_FOREVER           (~(0U))
+
+typedef struct UART_Config_ *UART_Handle;
+
+typedef void (*UART_Callback)(UART_Handle handle, void *buf, size_t count);
+
+typedef enum {
+    UART_MODE_BLOCKING,
+    UART_MODE_CALLBACK
+} UART_Mode;
+
+typedef enum {
+    UART_RETURN_NEWLINE,
+    UART_RETURN_FULL
+} UART_ReturnMode;
+
+typedef enum {
+    UART_DATA_BINARY = 0,
+    UART_DATA_TEXT = 1
+} UART_DataMode;
+
+typedef enum {
+    UART_ECHO_OFF = 0,
+    UART_ECHO_ON = 1
+} UART_Echo;
+
+typedef enum {
+    UART_LEN_5 = 0,
+    UART_LEN_6 = 1,
+    UART_LEN_7 = 2,
+    UART_LEN_8 = 3
+} UART_LEN;
+
+typedef enum {
+    UART_STOP_ONE = 0,
+    UART_STOP_TWO = 1
+} UART_STOP;
+
+typedef enum {
+    UART_PAR_NONE = 0,
+    UART_PAR_EVEN = 1,
+    UART_PAR_ODD  = 2,
+    UART_PAR_ZERO = 3,
+    UART_PAR_ONE  = 4
+} UART_PAR;
+
+typedef struct {
+    UART_Mode       readMode;
+    UART_Mode       writeMode;
+    uint32_t        readTimeout;
+    uint32_t        writeTimeout;
+    UART_Callback   readCallback;
+    UART_Callback   writeCallback;
+    UART_ReturnMode readReturnMode;
+    UART_DataMode   readDataMode;
+    UART_DataMode   writeDataMode;
+    UART_Echo       readEcho;
+    uint32_t        baudRate;
+    UART_LEN        dataLength;
+    UART_STOP       stopBits;
+    UART_PAR        parityType;
+    void           *custom;
+} UART_Params;
+
+typedef struct UART_Config_ {
+    void       *fxnTablePtr;
+    void       *object;
+    void const *hwAttrs;
+} UART_Config;
+
+extern void UART_close(UART_Handle handle);
+extern int_fast16_t UART_control(UART_Handle handle, uint_fast16_t cmd, void *arg);
+extern void UART_init(void);
+extern UART_Handle UART_open(uint_least8_t index, UART_Params *params);
+extern void UART_Params_init(UART_Params *params);
+extern int_fast32_t UART_read(UART_Handle handle, void *buffer, size_t size);
+extern void UART_readCancel(UART_Handle handle);
+extern int_fast32_t UART_write(UART_Handle handle, const void *buffer, size_t size);
+extern void UART_writeCancel(UART_Handle handle);
+extern int_fast32_t UART_writePolling(UART_Handle handle, const void *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ti_drivers_UART__include */
@@ -0,0 +1,26 @@
+/*
+ *  ======== HwiP.h ========
+ *  Host stand-in for the interrupt masking part of <ti/drivers/dpl/HwiP.h>.
+ *  Masking blocks the HostSim interrupt signal.
+ */
+
+#ifndef ti_dpl_HwiP__include
+#define ti_dpl_HwiP__include
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uintptr_t HwiP_disable(void);
+extern void HwiP_enable(void);
+extern bool HwiP_inISR(void);
+extern void HwiP_restore(uintptr_t key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ti_dpl_HwiP__include */
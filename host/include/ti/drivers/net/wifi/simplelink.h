@@ -0,0 +1,52 @@
+/*
+ *  ======== simplelink.h ========
+ *  Host stand-in for the parts of the SimpleLink Wi-Fi host driver the
+ *  projects use: starting the network processor and its serial flash file
+ *  system. Files live in the HOST_FS_DIR directory.
+ */
+
+#ifndef ti_drivers_net_wifi_simplelink__include
+#define ti_drivers_net_wifi_simplelink__include
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int8_t   _i8;
+typedef uint8_t  _u8;
+typedef int16_t  _i16;
+typedef uint16_t _u16;
+typedef int32_t  _i32;
+typedef uint32_t _u32;
+
+typedef void (*P_INIT_CALLBACK)(_u32 status, void *deviceInfo);
+
+#define ROLE_STA                    (0)
+
+#define SL_ERROR_FS_FILE_NOT_EXISTS (-10341)
+#define SL_ERROR_FS_FAILED_TO_READ  (-10290)
+#define SL_ERROR_FS_FAILED_TO_WRITE (-10289)
+
+#define SL_FS_READ                  ((_u32)0x0 << 12)
+#define SL_FS_WRITE                 ((_u32)0x1 << 12)
+#define SL_FS_CREATE                ((_u32)0x2 << 12)
+#define SL_FS_OVERWRITE             ((_u32)0x3 << 12)
+#define SL_FS_CREATE_MAX_SIZE(size) ((_u32)(size) & 0xFFF)
+
+_i32 sl_Start(const void *pIfHdl, _i8 *pDevName, const P_INIT_CALLBACK pInitCallBack);
+_i16 sl_Stop(const _u16 timeout);
+
+_i32 sl_FsOpen(const _u8 *pFileName, const _u32 accessModeAndMaxSize, _u32 *pToken);
+_i16 sl_FsClose(const _i32 fileHdl, const _u8 *pCeritificateFileName,
+                const _u8 *pSignature, const _u32 signatureLen);
+_i32 sl_FsRead(const _i32 fileHdl, _u32 offset, _u8 *pData, _u32 len);
+_i32 sl_FsWrite(const _i32 fileHdl, _u32 offset, _u8 *pData, _u32 len);
+_i16 sl_FsDel(const _u8 *pFileName, const _u32 token);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
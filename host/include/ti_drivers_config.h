@@ -0,0 +1,73 @@
+/*
+ *  ======== ti_drivers_config.h ========
+ *  Host build replacement for the SysConfig generated header.
+ *
+ *  Declares the union of the instances used by the gpiointerrupt, uartecho
+ *  and pwmled2 projects so a single stand-in library serves all of them.
+ *  Index values match the CC3220S_LAUNCHXL SysConfig output.
+ */
+#ifndef ti_drivers_config_h
+#define ti_drivers_config_h
+
+#define CONFIG_CC3220S_LAUNCHXL
+#define CONFIG_TI_HOST_BUILD
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ *  ======== GPIO ========
+ */
+#define CONFIG_GPIO_BUTTON_0            0
+#define CONFIG_GPIO_BUTTON_1            1
+#define CONFIG_GPIO_LED_0               2
+#define CONFIG_GPIO_LED_1               3
+#define CONFIG_GPIO_HEATER_1            4
+#define CONFIG_GPIO_HEATER_2            5
+#define CONFIG_TI_DRIVERS_GPIO_COUNT    6
+
+/* LEDs are active high */
+#define CONFIG_GPIO_LED_ON  (1)
+#define CONFIG_GPIO_LED_OFF (0)
+
+#define CONFIG_LED_ON  (CONFIG_GPIO_LED_ON)
+#define CONFIG_LED_OFF (CONFIG_GPIO_LED_OFF)
+
+/*
+ *  ======== I2C ========
+ */
+#define CONFIG_I2C_0                    0
+#define CONFIG_TI_DRIVERS_I2C_COUNT     1
+
+/*
+ *  ======== PWM ========
+ */
+#define CONFIG_PWM_0                    0
+#define CONFIG_PWM_1                    1
+#define CONFIG_TI_DRIVERS_PWM_COUNT     2
+
+/*
+ *  ======== Timer ========
+ */
+#define CONFIG_TIMER_0                  0
+#define CONFIG_TIMER_1                  1
+#define CONFIG_TI_DRIVERS_TIMER_COUNT   2
+
+/*
+ *  ======== UART ========
+ */
+#define CONFIG_UART_0                   0
+#define CONFIG_TI_DRIVERS_UART_COUNT    1
+
+extern void Board_init(void);
+
+#define Board_initGeneral Board_init
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
@@ -0,0 +1,30 @@
+/*
+ *  ======== Board.c ========
+ *  Host stand-ins for Board_init() and the NoRTOS kernel.
+ */
+
+#include <NoRTOS.h>
+#include <ti/drivers/Board.h>
+
+#include "HostSim.h"
+
+static NoRTOS_Config noRtosConfig = { NULL, 1000, 0 };
+
+/*
+ *  ======== Board_init ========
+ *  Brings up the simulated hardware; see HostSim.h for the knobs.
+ */
+void Board_init(void) {
+    HostSim_init();
+}
+
+void NoRTOS_getConfig(NoRTOS_Config *cfg) {
+    *cfg = noRtosConfig;
+}
+
+void NoRTOS_setConfig(NoRTOS_Config *cfg) {
+    noRtosConfig = *cfg;
+}
+
+void NoRTOS_start(void) {
+}
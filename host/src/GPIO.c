@@ -0,0 +1,212 @@
+/*
+ *  ======== GPIO.c ========
+ *  Host stand-in for the GPIO driver.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <ti/drivers/GPIO.h>
+
+#include "HostSim.h"
+#include "ti_drivers_config.h"
+
+#define MAX_SCHEDULED_PRESSES   64
+
+typedef struct {
+    GPIO_PinConfig   config;
+    GPIO_CallbackFxn callback;
+    uint_fast8_t     value;
+    bool             intEnabled;
+} PinState;
+
+static PinState pins[CONFIG_TI_DRIVERS_GPIO_COUNT];
+static HostSim_Irq presses[MAX_SCHEDULED_PRESSES];
+static HostSim_Irq releases[MAX_SCHEDULED_PRESSES];
+static int pressCount = 0;
+static uint64_t bounces = 3;
+
+/*
+ *  ======== validIndex ========
+ */
+static bool validIndex(uint_least8_t index) {
+    return index < CONFIG_TI_DRIVERS_GPIO_COUNT;
+}
+
+/*
+ *  ======== pressFxn ========
+ *  Interrupt body for a scheduled button press.
+ */
+static void pressFxn(uintptr_t arg) {
+    GPIO_hostInject((uint_least8_t)arg, 0);
+}
+
+/*
+ *  ======== releaseFxn ========
+ */
+static void releaseFxn(uintptr_t arg) {
+    GPIO_hostInject((uint_least8_t)arg, 1);
+}
+
+void GPIO_init(void) {
+}
+
+void GPIO_clearInt(uint_least8_t index) {
+    (void)index;
+}
+
+void GPIO_disableInt(uint_least8_t index) {
+    if (validIndex(index)) {
+        pins[index].intEnabled = false;
+    }
+}
+
+void GPIO_enableInt(uint_least8_t index) {
+    if (validIndex(index)) {
+        pins[index].intEnabled = true;
+    }
+}
+
+void GPIO_getConfig(uint_least8_t index, GPIO_PinConfig *pinConfig) {
+    *pinConfig = validIndex(index) ? pins[index].config : 0;
+}
+
+uint_fast8_t GPIO_read(uint_least8_t index) {
+    return validIndex(index) ? pins[index].value : 0;
+}
+
+void GPIO_setCallback(uint_least8_t index, GPIO_CallbackFxn callback) {
+    if (validIndex(index)) {
+        pins[index].callback = callback;
+    }
+}
+
+/*
+ *  ======== GPIO_setConfig ========
+ *  Inputs with a pull-up idle high, matching the LaunchPad buttons.
+ */
+int_fast16_t GPIO_setConfig(uint_least8_t index, GPIO_PinConfig pinConfig) {
+    if (!validIndex(index)) {
+        return GPIO_STATUS_ERROR;
+    }
+    if (pinConfig & GPIO_DO_NOT_CONFIG) {
+        return GPIO_STATUS_SUCCESS;
+    }
+
+    pins[index].config = pinConfig;
+    if ((pinConfig & GPIO_CFG_INPUT) != 0) {
+        pins[index].value = ((pinConfig & GPIO_CFG_IN_PU) == GPIO_CFG_IN_PU) ? 1 : 0;
+    } else {
+        pins[index].value = (pinConfig & GPIO_CFG_OUT_HIGH) ? 1 : 0;
+    }
+    return GPIO_STATUS_SUCCESS;
+}
+
+void GPIO_toggle(uint_least8_t index) {
+    if (validIndex(index)) {
+        GPIO_write(index, !pins[index].value);
+    }
+}
+
+void GPIO_write(uint_least8_t index, unsigned int value) {
+    if (!validIndex(index)) {
+        return;
+    }
+    HostSim_counters.gpioWrites++;
+    value = value ? 1 : 0;
+    if (HostSim_trace() && pins[index].value != value) {
+        fprintf(stderr, "[host %10.6f] gpio %u -> %u\n",
+                HostSim_nowUs() / 1e6, (unsigned)index, value);
+    }
+    pins[index].value = value;
+}
+
+/*
+ *  ======== edge ========
+ *  Change an input level and raise its interrupt if enabled for that edge.
+ */
+static void edge(uint_least8_t index, uint_fast8_t value) {
+    PinState *pin = &pins[index];
+    GPIO_PinConfig type = pin->config & GPIO_CFG_INT_MASK;
+    bool match;
+
+    if (pin->value == value) {
+        return;
+    }
+    pin->value = value;
+    HostSim_counters.gpioEdges++;
+
+    match = (type == GPIO_CFG_IN_INT_BOTH_EDGES) ||
+            (type == (value ? GPIO_CFG_IN_INT_RISING : GPIO_CFG_IN_INT_FALLING));
+    if (!match || pin->callback == NULL) {
+        return;
+    }
+    if (!pin->intEnabled) {
+        HostSim_counters.gpioEdgesMasked++;
+        return;
+    }
+    pin->callback(index);
+}
+
+/*
+ *  ======== GPIO_hostInject ========
+ *  Drive a button input to value (0 = pressed for the pulled-up LaunchPad
+ *  buttons), bouncing HOST_BOUNCE times on the way. Must run in simulated
+ *  interrupt context.
+ */
+void GPIO_hostInject(uint_least8_t index, uint_fast8_t value) {
+    uint64_t i;
+
+    if (!validIndex(index)) {
+        return;
+    }
+    value = value ? 1 : 0;
+    for (i = 0; i < bounces; i++) {
+        edge(index, value);
+        edge(index, !value);
+    }
+    edge(index, value);
+}
+
+/*
+ *  ======== GPIO_hostSchedule ========
+ *  Parse "index@seconds[:hold][,...]" and arm a press and a release
+ *  interrupt for each entry.
+ */
+void GPIO_hostSchedule(const char *spec) {
+    const char *p = spec;
+    char *end;
+
+    bounces = HostSim_envU64("HOST_BOUNCE", 3);
+
+    while (*p != '\0' && pressCount < MAX_SCHEDULED_PRESSES) {
+        unsigned long index = strtoul(p, &end, 0);
+        double seconds, hold = 0.15;
+
+        if (end == p || *end != '@') {
+            fprintf(stderr, "[host] bad HOST_BUTTONS entry at \"%s\"\n", p);
+            return;
+        }
+        p = end + 1;
+        seconds = strtod(p, &end);
+        if (end == p) {
+            fprintf(stderr, "[host] bad HOST_BUTTONS time at \"%s\"\n", p);
+            return;
+        }
+        if (*end == ':') {
+            p = end + 1;
+            hold = strtod(p, &end);
+            if (end == p || hold <= 0.0) {
+                fprintf(stderr, "[host] bad HOST_BUTTONS hold at \"%s\"\n", p);
+                return;
+            }
+        }
+        p = (*end == ',') ? end + 1 : end;
+
+        HostSim_irqCreate(&presses[pressCount], HostSim_IRQ_GPIO, pressFxn, (uintptr_t)index);
+        HostSim_irqArm(&presses[pressCount], (uint64_t)(seconds * 1e6), 0);
+        HostSim_irqCreate(&releases[pressCount], HostSim_IRQ_GPIO, releaseFxn, (uintptr_t)index);
+        HostSim_irqArm(&releases[pressCount], (uint64_t)((seconds + hold) * 1e6), 0);
+        pressCount++;
+    }
+}
@@ -0,0 +1,381 @@
+/*
+ *  ======== HostSim.c ========
+ *  Virtual clock, simulated interrupt delivery and run statistics for the
+ *  host build. See HostSim.h for the environment variables.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "HostSim.h"
+
+HostSim_Counters HostSim_counters;
+HostSim_IsrStats HostSim_isrStats[HostSim_IRQ_COUNT];
+
+static const char *irqNames[HostSim_IRQ_COUNT] = { "timer", "gpio", "i2c", "uart" };
+
+static bool initialized = false;
+static double timeScale = 1.0;
+static bool modelBus = true;
+static bool traceOn = false;
+static struct timespec startMono;
+static HostSim_Irq stopIrq;
+
+/* File descriptors that raise an interrupt when input arrives */
+#define WATCH_MAX 4
+static struct {
+    int          fd;
+    HostSim_Irq *irq;
+} watches[WATCH_MAX];
+static int watchCount = 0;
+
+/*
+ *  ======== monoNs ========
+ */
+static uint64_t monoNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ *  ======== virtualToTimespec ========
+ *  Convert a virtual duration to the wall clock interval it takes.
+ */
+static struct timespec virtualToTimespec(uint64_t us) {
+    struct timespec ts;
+    uint64_t ns = (uint64_t)((double)us * 1000.0 / timeScale);
+
+    if (us != 0 && ns == 0) {
+        ns = 1;  /* Zero would disarm a POSIX timer */
+    }
+    ts.tv_sec = ns / 1000000000u;
+    ts.tv_nsec = ns % 1000000000u;
+    return ts;
+}
+
+/*
+ *  ======== irqHandler ========
+ *  Signal handler standing in for the NVIC. The signal is blocked while the
+ *  handler runs, so simulated interrupts never nest. Timer signals carry
+ *  their HostSim_Irq; input signals from a watched fd are looked up by fd.
+ */
+static void irqHandler(int sig, siginfo_t *info, void *context) {
+    HostSim_Irq *irq = NULL;
+    HostSim_IsrStats *stats;
+    uint64_t start, elapsed;
+    int savedErrno = errno;
+    int i;
+
+    (void)sig;
+    (void)context;
+
+    if (info->si_code == SI_TIMER) {
+        irq = (HostSim_Irq *)info->si_value.sival_ptr;
+    } else {
+        for (i = 0; i < watchCount; i++) {
+            if (watches[i].fd == info->si_fd) {
+                irq = watches[i].irq;
+            }
+        }
+    }
+
+    if (irq == NULL || irq->fxn == NULL) {
+        return;
+    }
+
+    start = monoNs();
+    irq->fxn(irq->arg);
+    elapsed = monoNs() - start;
+
+    stats = &HostSim_isrStats[irq->source];
+    stats->count++;
+    stats->totalNs += elapsed;
+    if (elapsed > stats->maxNs) {
+        stats->maxNs = elapsed;
+    }
+    errno = savedErrno;
+}
+
+/*
+ *  ======== stopFxn ========
+ *  Ends the run once HOST_RUN_SECONDS of virtual time have elapsed.
+ */
+static void stopFxn(uintptr_t arg) {
+    (void)arg;
+    HostSim_report();
+    _exit(0);
+}
+
+/*
+ *  ======== interruptFxn ========
+ */
+static void interruptFxn(int sig) {
+    (void)sig;
+    HostSim_report();
+    _exit(130);
+}
+
+/*
+ *  ======== HostSim_envU64 ========
+ *  Accepts decimal or 0x-prefixed hex.
+ */
+uint64_t HostSim_envU64(const char *name, uint64_t defaultValue) {
+    const char *value = getenv(name);
+    char *end;
+    unsigned long long parsed;
+
+    if (value == NULL || *value == '\0') {
+        return defaultValue;
+    }
+    parsed = strtoull(value, &end, 0);
+    return (*end == '\0') ? (uint64_t)parsed : defaultValue;
+}
+
+/*
+ *  ======== HostSim_envDouble ========
+ */
+double HostSim_envDouble(const char *name, double defaultValue) {
+    const char *value = getenv(name);
+    char *end;
+    double parsed;
+
+    if (value == NULL || *value == '\0') {
+        return defaultValue;
+    }
+    parsed = strtod(value, &end);
+    return (*end == '\0') ? parsed : defaultValue;
+}
+
+/*
+ *  ======== HostSim_init ========
+ *  Called from Board_init(). Safe to call more than once.
+ */
+void HostSim_init(void) {
+    struct sigaction sa;
+    uint64_t runSeconds;
+    const char *buttons;
+
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+
+    timeScale = HostSim_envDouble("HOST_TIME_SCALE", 1.0);
+    if (timeScale <= 0.0) {
+        timeScale = 1.0;
+    }
+    modelBus = HostSim_envU64("HOST_MODEL_BUS", 1) != 0;
+    traceOn = HostSim_envU64("HOST_TRACE", 0) != 0;
+
+    /* The CCS console is unbuffered; match that so ISR output is not lost */
+    setvbuf(stdout, NULL, _IONBF, 0);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = irqHandler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGRTMIN, &sa, NULL);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = interruptFxn;
+    sigemptyset(&sa.sa_mask);
+    sigaddset(&sa.sa_mask, SIGRTMIN);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &startMono);
+
+    I2C_hostConfigure();
+
+    buttons = getenv("HOST_BUTTONS");
+    if (buttons != NULL) {
+        GPIO_hostSchedule(buttons);
+    }
+
+    runSeconds = HostSim_envU64("HOST_RUN_SECONDS", 0);
+    if (runSeconds != 0) {
+        HostSim_irqCreate(&stopIrq, HostSim_IRQ_TIMER, stopFxn, 0);
+        HostSim_irqArm(&stopIrq, runSeconds * 1000000u, 0);
+    }
+}
+
+/*
+ *  ======== HostSim_nowUs ========
+ *  Virtual microseconds since HostSim_init().
+ */
+uint64_t HostSim_nowUs(void) {
+    uint64_t start = (uint64_t)startMono.tv_sec * 1000000000u + (uint64_t)startMono.tv_nsec;
+
+    return (uint64_t)((double)(monoNs() - start) * timeScale / 1000.0);
+}
+
+/*
+ *  ======== HostSim_sleepUs ========
+ *  Block for a virtual duration. Simulated interrupts are still serviced.
+ */
+void HostSim_sleepUs(uint64_t us) {
+    struct timespec remaining = virtualToTimespec(us);
+
+    while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR) {
+    }
+}
+
+bool HostSim_modelBus(void) {
+    return modelBus;
+}
+
+bool HostSim_trace(void) {
+    return traceOn;
+}
+
+/*
+ *  ======== HostSim_irqCreate ========
+ */
+void HostSim_irqCreate(HostSim_Irq *irq, HostSim_IrqSource source,
+                       HostSim_IrqFxn fxn, uintptr_t arg) {
+    struct sigevent sev;
+
+    irq->fxn = fxn;
+    irq->arg = arg;
+    irq->source = source;
+    if (irq->created) {
+        return;
+    }
+
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_SIGNAL;
+    sev.sigev_signo = SIGRTMIN;
+    sev.sigev_value.sival_ptr = irq;
+    if (timer_create(CLOCK_MONOTONIC, &sev, &irq->timer) != 0) {
+        perror("timer_create");
+        exit(1);
+    }
+    irq->created = true;
+}
+
+/*
+ *  ======== HostSim_irqArm ========
+ *  Raise the interrupt after delayUs, then every intervalUs (0 = once).
+ */
+void HostSim_irqArm(HostSim_Irq *irq, uint64_t delayUs, uint64_t intervalUs) {
+    struct itimerspec its;
+
+    its.it_value = virtualToTimespec(delayUs == 0 ? 1 : delayUs);
+    its.it_interval = virtualToTimespec(intervalUs);
+    timer_settime(irq->timer, 0, &its, NULL);
+}
+
+/*
+ *  ======== HostSim_irqDisarm ========
+ */
+void HostSim_irqDisarm(HostSim_Irq *irq) {
+    struct itimerspec its;
+
+    if (!irq->created) {
+        return;
+    }
+    memset(&its, 0, sizeof(its));
+    timer_settime(irq->timer, 0, &its, NULL);
+}
+
+/*
+ *  ======== HostSim_irqWatchFd ========
+ *  Also raise the interrupt whenever input arrives on fd. The handler must
+ *  check for itself whether data is ready, as a level-triggered ISR would.
+ */
+void HostSim_irqWatchFd(HostSim_Irq *irq, int fd) {
+    int flags;
+
+    if (watchCount == WATCH_MAX) {
+        return;
+    }
+    watches[watchCount].fd = fd;
+    watches[watchCount].irq = irq;
+    watchCount++;
+
+    fcntl(fd, F_SETOWN, getpid());
+    fcntl(fd, F_SETSIG, SIGRTMIN);
+    flags = fcntl(fd, F_GETFL);
+    fcntl(fd, F_SETFL, flags | O_ASYNC);
+}
+
+/*
+ *  ======== HostSim_report ========
+ *  Print where the process spent its time. Runs from signal context, so
+ *  output goes straight to fd 2.
+ */
+void HostSim_report(void) {
+    char line[160];
+    struct timespec cpu;
+    uint64_t wallNs, cpuNs, isrNs = 0;
+    int i, n;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+    cpuNs = (uint64_t)cpu.tv_sec * 1000000000u + (uint64_t)cpu.tv_nsec;
+    wallNs = monoNs() - ((uint64_t)startMono.tv_sec * 1000000000u + (uint64_t)startMono.tv_nsec);
+    if (wallNs == 0) {
+        wallNs = 1;
+    }
+
+    n = snprintf(line, sizeof(line),
+                 "\n[host] virtual %.3f s, wall %.3f s, cpu %.3f s (%.1f%% of wall)\n",
+                 HostSim_nowUs() / 1e6, wallNs / 1e9, cpuNs / 1e9, 100.0 * cpuNs / wallNs);
+    write(2, line, n);
+
+    if (HostSim_counters.wfiCount != 0 || HostSim_counters.wfiSinceUs != 0) {
+        uint64_t virtualUs = HostSim_nowUs();
+        uint64_t idleUs = HostSim_counters.idleUs;
+
+        /* Include the sleep the run ended in */
+        if (HostSim_counters.wfiSinceUs != 0) {
+            idleUs += virtualUs - HostSim_counters.wfiSinceUs;
+        }
+        n = snprintf(line, sizeof(line),
+                     "[host] wfi %u times, idle %.3f s (%.1f%% of virtual)\n",
+                     HostSim_counters.wfiCount, idleUs / 1e6,
+                     virtualUs ? 100.0 * idleUs / virtualUs : 0.0);
+        write(2, line, n);
+    }
+
+    for (i = 0; i < HostSim_IRQ_COUNT; i++) {
+        const HostSim_IsrStats *s = &HostSim_isrStats[i];
+
+        if (s->count == 0) {
+            continue;
+        }
+        isrNs += s->totalNs;
+        n = snprintf(line, sizeof(line),
+                     "[host] isr %-5s count %u, mean %.2f us, max %.2f us\n",
+                     irqNames[i], s->count, s->totalNs / 1e3 / s->count, s->maxNs / 1e3);
+        write(2, line, n);
+    }
+
+    n = snprintf(line, sizeof(line),
+                 "[host] thread cpu %.3f s, isr cpu %.3f s\n",
+                 (cpuNs > isrNs ? cpuNs - isrNs : 0) / 1e9, isrNs / 1e9);
+    write(2, line, n);
+
+    if (HostSim_counters.gpioEdges != 0) {
+        n = snprintf(line, sizeof(line),
+                     "[host] gpio input edges %u, %u with the interrupt masked\n",
+                     HostSim_counters.gpioEdges, HostSim_counters.gpioEdgesMasked);
+        write(2, line, n);
+    }
+
+    n = snprintf(line, sizeof(line),
+                 "[host] uart writes %u, bytes %llu, wire %.3f s; i2c transfers %u (nack %u), bus %.3f s\n",
+                 HostSim_counters.uartWrites,
+                 (unsigned long long)HostSim_counters.uartBytesOut,
+                 HostSim_counters.uartWireUs / 1e6,
+                 HostSim_counters.i2cTransfers, HostSim_counters.i2cNacks,
+                 HostSim_counters.i2cBusUs / 1e6);
+    write(2, line, n);
+}
@@ -0,0 +1,300 @@
+/*
+ *  ======== I2C.c ========
+ *  Host stand-in for the I2C driver with simulated TMP sensors.
+ *
+ *  The sensors answer at the addresses listed in HOST_I2C_SENSOR, and read
+ *  the matching entries of HOST_TEMP_MC (the last one repeats). A family
+ *  follows from the address, as in the thermostat's TempSensor drivers:
+ *  0x48 TMP11X, 0x49 TMP116, 0x40-0x47 TMP006. All three report
+ *  temperature with a 1/128 degree C LSB, from register 0x01 (TMP006) or
+ *  0x00 (TMP11x).
+ *
+ *  In I2C_MODE_CALLBACK, transactions are queued through nextPtr as in the
+ *  SimpleLink driver and each one completes in simulated interrupt context
+ *  after its bus time.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/drivers/I2C.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "HostSim.h"
+#include "ti_drivers_config.h"
+
+typedef struct {
+    I2C_Params       params;
+    HostSim_Irq      irq;
+    I2C_Transaction *head;
+    I2C_Transaction *tail;
+    bool             open;
+} I2CObject;
+
+static I2CObject objects[CONFIG_TI_DRIVERS_I2C_COUNT];
+static I2C_Config configs[CONFIG_TI_DRIVERS_I2C_COUNT];
+
+#define MAX_SENSORS 8
+
+typedef struct {
+    uint8_t address;
+    int32_t tempMilliC;
+    uint8_t pointer;  /* Register selected by the last write */
+} Sensor;
+
+static Sensor sensors[MAX_SENSORS];
+static int sensorCount;
+
+/*
+ *  ======== isTmp006 ========
+ */
+static bool isTmp006(uint8_t address) {
+    return (address & 0xF8) == 0x40;
+}
+
+/*
+ *  ======== readRegister ========
+ *  16-bit register file of the simulated sensor.
+ */
+static uint16_t readRegister(const Sensor *sensor, uint8_t reg) {
+    int32_t raw = (sensor->tempMilliC * 128) / 1000;
+
+    if (isTmp006(sensor->address)) {
+        switch (reg) {
+            case 0x01: return (uint16_t)(int16_t)raw;   /* Die temperature */
+            case 0xFE: return 0x5449;                   /* Manufacturer ID */
+            case 0xFF: return 0x0067;                   /* Device ID */
+            default:   return 0;
+        }
+    }
+    switch (reg) {
+        case 0x00: return (uint16_t)(int16_t)raw;       /* Temperature */
+        case 0x01: return 0x0220;                       /* Configuration */
+        case 0x0F: return (sensor->address == 0x49) ? 0x1116 : 0x0117;  /* Device ID */
+        default:   return 0;
+    }
+}
+
+/*
+ *  ======== busTimeUs ========
+ *  Time the transaction occupies the wire: 9 bits per byte plus the
+ *  address bytes and start/stop conditions.
+ */
+static uint64_t busTimeUs(const I2CObject *object, const I2C_Transaction *transaction) {
+    static const uint32_t rates[] = { 100000, 400000, 1000000, 3330000, 3400000 };
+    uint32_t rate = rates[object->params.bitRate <= I2C_3400kHz ? object->params.bitRate : 0];
+    uint64_t bits = 2;
+
+    if (transaction->writeCount > 0) {
+        bits += 9 * (1 + transaction->writeCount);
+    }
+    if (transaction->readCount > 0) {
+        bits += 9 * (1 + transaction->readCount);
+    }
+    return (bits * 1000000u + rate - 1) / rate;
+}
+
+/*
+ *  ======== execute ========
+ *  Perform the transaction against the simulated sensor.
+ */
+static bool execute(I2C_Transaction *transaction) {
+    Sensor *sensor = NULL;
+    int s;
+    size_t i;
+
+    for (s = 0; s < sensorCount; s++) {
+        if (sensors[s].address == transaction->slaveAddress) {
+            sensor = &sensors[s];
+        }
+    }
+    if (sensor == NULL) {
+        HostSim_counters.i2cNacks++;
+        return false;
+    }
+
+    if (transaction->writeCount > 0) {
+        sensor->pointer = ((const uint8_t *)transaction->writeBuf)[0];
+    }
+    if (transaction->readCount > 0) {
+        uint16_t value = readRegister(sensor, sensor->pointer);
+        uint8_t *rx = transaction->readBuf;
+
+        for (i = 0; i < transaction->readCount; i++) {
+            rx[i] = (i & 1) ? (uint8_t)value : (uint8_t)(value >> 8);
+        }
+    }
+    return true;
+}
+
+/*
+ *  ======== startNext ========
+ *  Put the transaction at the head of the queue on the bus.
+ */
+static void startNext(I2CObject *object) {
+    if (object->head != NULL) {
+        HostSim_irqArm(&object->irq, busTimeUs(object, object->head), 0);
+    }
+}
+
+/*
+ *  ======== completeFxn ========
+ *  Interrupt body: finish the head transaction and start the next one.
+ */
+static void completeFxn(uintptr_t arg) {
+    I2C_Config *config = (I2C_Config *)arg;
+    I2CObject *object = config->object;
+    I2C_Transaction *transaction = object->head;
+    bool status;
+
+    if (transaction == NULL) {
+        return;
+    }
+    object->head = transaction->nextPtr;
+    if (object->head == NULL) {
+        object->tail = NULL;
+    }
+
+    status = execute(transaction);
+    startNext(object);
+    object->params.transferCallbackFxn((I2C_Handle)config, transaction, status);
+}
+
+/*
+ *  ======== I2C_hostConfigure ========
+ */
+void I2C_hostConfigure(void) {
+    const char *addresses = getenv("HOST_I2C_SENSOR");
+    const char *temps = getenv("HOST_TEMP_MC");
+    double temp = 22000.0;
+    char *end;
+
+    if (addresses == NULL || *addresses == '\0') {
+        addresses = "0x41";
+    }
+    sensorCount = 0;
+    while (sensorCount < MAX_SENSORS && *addresses != '\0') {
+        sensors[sensorCount].address = (uint8_t)strtoul(addresses, &end, 0);
+        if (end == addresses) {
+            break;
+        }
+        if (temps != NULL && *temps != '\0') {
+            temp = strtod(temps, &end);
+            temps = (*end == ',') ? end + 1 : end;
+        }
+        sensors[sensorCount].tempMilliC = (int32_t)temp;
+        sensors[sensorCount].pointer = 0;
+        sensorCount++;
+
+        addresses = strchr(addresses, ',');
+        if (addresses == NULL) {
+            break;
+        }
+        addresses++;
+    }
+}
+
+void I2C_init(void) {
+}
+
+void I2C_Params_init(I2C_Params *params) {
+    params->transferMode = I2C_MODE_BLOCKING;
+    params->transferCallbackFxn = NULL;
+    params->bitRate = I2C_100kHz;
+    params->custom = NULL;
+}
+
+/*
+ *  ======== I2C_open ========
+ */
+I2C_Handle I2C_open(uint_least8_t index, I2C_Params *params) {
+    I2C_Params defaults;
+
+    if (index >= CONFIG_TI_DRIVERS_I2C_COUNT || objects[index].open) {
+        return NULL;
+    }
+    if (params == NULL) {
+        I2C_Params_init(&defaults);
+        params = &defaults;
+    }
+    if (params->transferMode == I2C_MODE_CALLBACK && params->transferCallbackFxn == NULL) {
+        return NULL;
+    }
+
+    objects[index].params = *params;
+    objects[index].head = NULL;
+    objects[index].tail = NULL;
+    objects[index].open = true;
+    configs[index].object = &objects[index];
+    HostSim_irqCreate(&objects[index].irq, HostSim_IRQ_I2C, completeFxn, (uintptr_t)&configs[index]);
+    return (I2C_Handle)&configs[index];
+}
+
+/*
+ *  ======== I2C_cancel ========
+ *  Fail every queued transaction through the callback.
+ */
+void I2C_cancel(I2C_Handle handle) {
+    I2CObject *object = handle->object;
+    I2C_Transaction *transaction;
+
+    HostSim_irqDisarm(&object->irq);
+    while ((transaction = object->head) != NULL) {
+        object->head = transaction->nextPtr;
+        object->params.transferCallbackFxn(handle, transaction, false);
+    }
+    object->tail = NULL;
+}
+
+void I2C_close(I2C_Handle handle) {
+    I2CObject *object = handle->object;
+
+    if (object->params.transferMode == I2C_MODE_CALLBACK) {
+        I2C_cancel(handle);
+    }
+    object->open = false;
+}
+
+int_fast16_t I2C_control(I2C_Handle handle, uint_fast16_t cmd, void *controlArg) {
+    (void)handle;
+    (void)cmd;
+    (void)controlArg;
+    return I2C_STATUS_UNDEFINEDCMD;
+}
+
+/*
+ *  ======== I2C_transfer ========
+ *  A write sets the register pointer; a read returns the register MSB first.
+ *  In callback mode the return value only says whether it was queued.
+ */
+bool I2C_transfer(I2C_Handle handle, I2C_Transaction *transaction) {
+    I2CObject *object = handle->object;
+    uint64_t busUs = busTimeUs(object, transaction);
+    bool idle;
+
+    HostSim_counters.i2cTransfers++;
+    HostSim_counters.i2cBusUs += busUs;
+
+    if (object->params.transferMode == I2C_MODE_CALLBACK) {
+        uintptr_t key = HwiP_disable();
+
+        transaction->nextPtr = NULL;
+        idle = (object->head == NULL);
+        if (idle) {
+            object->head = transaction;
+        } else {
+            object->tail->nextPtr = transaction;
+        }
+        object->tail = transaction;
+        if (idle) {
+            startNext(object);
+        }
+        HwiP_restore(key);
+        return true;
+    }
+
+    if (HostSim_modelBus()) {
+        HostSim_sleepUs(busUs);
+    }
+    return execute(transaction);
+}
@@ -0,0 +1,97 @@
+/*
+ *  ======== PWM.c ========
+ *  Host stand-in for the PWM driver.
+ */
+
+#include <stdio.h>
+
+#include <ti/drivers/PWM.h>
+
+#include "HostSim.h"
+#include "ti_drivers_config.h"
+
+typedef struct {
+    PWM_Params params;
+    uint32_t   duty;
+    bool       open;
+    bool       running;
+} PWMObject;
+
+static PWMObject objects[CONFIG_TI_DRIVERS_PWM_COUNT];
+static PWM_Config configs[CONFIG_TI_DRIVERS_PWM_COUNT];
+
+void PWM_init(void) {
+}
+
+void PWM_Params_init(PWM_Params *params) {
+    params->periodUnits = PWM_PERIOD_HZ;
+    params->periodValue = 1000000;
+    params->dutyUnits = PWM_DUTY_FRACTION;
+    params->dutyValue = 0;
+    params->idleLevel = PWM_IDLE_LOW;
+    params->custom = NULL;
+}
+
+PWM_Handle PWM_open(uint_least8_t index, PWM_Params *params) {
+    PWM_Params defaults;
+
+    if (index >= CONFIG_TI_DRIVERS_PWM_COUNT || objects[index].open) {
+        return NULL;
+    }
+    if (params == NULL) {
+        PWM_Params_init(&defaults);
+        params = &defaults;
+    }
+
+    objects[index].params = *params;
+    objects[index].duty = params->dutyValue;
+    objects[index].open = true;
+    objects[index].running = false;
+    configs[index].object = &objects[index];
+    return (PWM_Handle)&configs[index];
+}
+
+void PWM_close(PWM_Handle handle) {
+    PWM_stop(handle);
+    ((PWMObject *)handle->object)->open = false;
+}
+
+int_fast16_t PWM_control(PWM_Handle handle, uint_fast16_t cmd, void *arg) {
+    (void)handle;
+    (void)cmd;
+    (void)arg;
+    return PWM_STATUS_UNDEFINEDCMD;
+}
+
+/*
+ *  ======== PWM_setDuty ========
+ */
+int_fast16_t PWM_setDuty(PWM_Handle handle, uint32_t duty) {
+    PWMObject *object = handle->object;
+
+    if (object->params.dutyUnits == PWM_DUTY_US &&
+        object->params.periodUnits == PWM_PERIOD_US && duty > object->params.periodValue) {
+        return PWM_STATUS_INVALID_DUTY;
+    }
+
+    HostSim_counters.pwmDutyChanges++;
+    if (HostSim_trace() && duty != object->duty) {
+        fprintf(stderr, "[host %10.6f] pwm %d duty -> %lu\n", HostSim_nowUs() / 1e6,
+                (int)(object - objects), (unsigned long)duty);
+    }
+    object->duty = duty;
+    return PWM_STATUS_SUCCESS;
+}
+
+int_fast16_t PWM_setPeriod(PWM_Handle handle, uint32_t period) {
+    ((PWMObject *)handle->object)->params.periodValue = period;
+    return PWM_STATUS_SUCCESS;
+}
+
+void PWM_start(PWM_Handle handle) {
+    ((PWMObject *)handle->object)->running = true;
+}
+
+void PWM_stop(PWM_Handle handle) {
+    ((PWMObject *)handle->object)->running = false;
+}
@@ -0,0 +1,193 @@
+/*
+ *  ======== Timer.c ========
+ *  Host stand-in for the Timer driver.
+ */
+
+#include <stdio.h>
+
+#include <ti/drivers/Timer.h>
+
+#include "HostSim.h"
+#include "ti_drivers_config.h"
+
+typedef struct {
+    Timer_Params params;
+    HostSim_Irq  irq;
+    uint64_t     periodUs;
+    uint64_t     startUs;
+    bool         open;
+    bool         running;
+} TimerObject;
+
+static TimerObject objects[CONFIG_TI_DRIVERS_TIMER_COUNT];
+static Timer_Config configs[CONFIG_TI_DRIVERS_TIMER_COUNT];
+
+/*
+ *  ======== toMicroseconds ========
+ */
+static uint64_t toMicroseconds(Timer_PeriodUnits units, uint32_t period) {
+    switch (units) {
+        case Timer_PERIOD_US:
+            return period;
+        case Timer_PERIOD_HZ:
+            return (period == 0) ? 0 : 1000000u / period;
+        case Timer_PERIOD_COUNTS:
+            return (uint64_t)period * 1000000u / HostSim_CPU_FREQ_HZ;
+    }
+    return 0;
+}
+
+/*
+ *  ======== timerFxn ========
+ *  Interrupt body: dispatch to the application callback.
+ */
+static void timerFxn(uintptr_t arg) {
+    Timer_Config *config = (Timer_Config *)arg;
+    TimerObject *object = config->object;
+
+    if (object->params.timerMode != Timer_CONTINUOUS_CALLBACK) {
+        object->running = false;
+    }
+    if (object->params.timerCallback != NULL) {
+        object->params.timerCallback((Timer_Handle)config, Timer_STATUS_SUCCESS);
+    }
+}
+
+/*
+ *  ======== arm ========
+ */
+static void arm(TimerObject *object) {
+    uint64_t interval = (object->params.timerMode == Timer_CONTINUOUS_CALLBACK) ? object->periodUs : 0;
+
+    HostSim_irqArm(&object->irq, object->periodUs, interval);
+}
+
+void Timer_init(void) {
+}
+
+void Timer_Params_init(Timer_Params *params) {
+    params->timerMode = Timer_ONESHOT_BLOCKING;
+    params->periodUnits = Timer_PERIOD_COUNTS;
+    params->timerCallback = NULL;
+    params->period = (uint32_t)~0;
+}
+
+/*
+ *  ======== Timer_open ========
+ */
+Timer_Handle Timer_open(uint_least8_t index, Timer_Params *params) {
+    TimerObject *object;
+    Timer_Config *config;
+    Timer_Params defaults;
+
+    if (index >= CONFIG_TI_DRIVERS_TIMER_COUNT || objects[index].open) {
+        return NULL;
+    }
+    if (params == NULL) {
+        Timer_Params_init(&defaults);
+        params = &defaults;
+    }
+    if ((params->timerMode == Timer_ONESHOT_CALLBACK ||
+         params->timerMode == Timer_CONTINUOUS_CALLBACK) && params->timerCallback == NULL) {
+        return NULL;
+    }
+
+    object = &objects[index];
+    config = &configs[index];
+    config->object = object;
+
+    object->params = *params;
+    object->periodUs = toMicroseconds(params->periodUnits, params->period);
+    if (object->periodUs == 0) {
+        return NULL;
+    }
+    object->open = true;
+    object->running = false;
+    HostSim_irqCreate(&object->irq, HostSim_IRQ_TIMER, timerFxn, (uintptr_t)config);
+
+    return (Timer_Handle)config;
+}
+
+void Timer_close(Timer_Handle handle) {
+    TimerObject *object = handle->object;
+
+    Timer_stop(handle);
+    object->open = false;
+}
+
+int_fast16_t Timer_control(Timer_Handle handle, uint_fast16_t cmd, void *arg) {
+    (void)handle;
+    (void)cmd;
+    (void)arg;
+    return Timer_STATUS_UNDEFINEDCMD;
+}
+
+/*
+ *  ======== Timer_getCount ========
+ *  Counts elapsed in the current period, at HostSim_CPU_FREQ_HZ.
+ */
+uint32_t Timer_getCount(Timer_Handle handle) {
+    TimerObject *object = handle->object;
+    uint64_t elapsed;
+
+    if (!object->running) {
+        return 0;
+    }
+    elapsed = HostSim_nowUs() - object->startUs;
+    if (object->params.timerMode != Timer_FREE_RUNNING && object->periodUs != 0) {
+        elapsed %= object->periodUs;
+    }
+    return (uint32_t)(elapsed * (HostSim_CPU_FREQ_HZ / 1000000u));
+}
+
+/*
+ *  ======== Timer_setPeriod ========
+ *  As on the CC32XX, a running timer restarts its count from the call.
+ */
+int32_t Timer_setPeriod(Timer_Handle handle, Timer_PeriodUnits periodUnits, uint32_t period) {
+    TimerObject *object = handle->object;
+    uint64_t periodUs = toMicroseconds(periodUnits, period);
+
+    if (periodUs == 0) {
+        return Timer_STATUS_ERROR;
+    }
+    object->periodUs = periodUs;
+    if (object->running) {
+        object->startUs = HostSim_nowUs();
+        arm(object);
+    }
+    return Timer_STATUS_SUCCESS;
+}
+
+/*
+ *  ======== Timer_start ========
+ */
+int32_t Timer_start(Timer_Handle handle) {
+    TimerObject *object = handle->object;
+
+    if (object->running) {
+        return Timer_STATUS_ERROR;
+    }
+    object->running = true;
+    object->startUs = HostSim_nowUs();
+
+    if (HostSim_trace()) {
+        fprintf(stderr, "[host %10.6f] timer start, period %llu us\n",
+                object->startUs / 1e6, (unsigned long long)object->periodUs);
+    }
+
+    if (object->params.timerMode == Timer_ONESHOT_BLOCKING) {
+        HostSim_sleepUs(object->periodUs);
+        object->running = false;
+    } else if (object->params.timerMode != Timer_FREE_RUNNING) {
+        arm(object);
+    }
+    return Timer_STATUS_SUCCESS;
+}
+
+void Timer_stop(Timer_Handle handle) {
+    TimerObject *object = handle->object;
+
+    HostSim_irqDisarm(&object->irq);
+    object->running = false;
+}
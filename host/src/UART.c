@@ -0,0 +1,344 @@
+/*
+ *  ======== UART.c ========
+ *  Host stand-in for the UART driver. Output goes to stdout, input comes
+ *  from stdin. Blocking writes last as long as the bytes take on the wire;
+ *  callback-mode writes complete in simulated interrupt context after it.
+ *  UART_DATA_TEXT writes send "\r\n" for every '\n', as the driver does.
+ *  Callback-mode reads complete in interrupt context once stdin has
+ *  delivered the requested bytes, no faster than the wire allows.
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <ti/drivers/UART.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "HostSim.h"
+#include "ti_drivers_config.h"
+
+typedef struct {
+    UART_Params params;
+    HostSim_Irq writeIrq;
+    const void *writeBuf;
+    size_t      writeSize;
+    bool        writeBusy;
+    HostSim_Irq readIrq;
+    void       *readBuf;
+    size_t      readSize;
+    size_t      readDone;
+    bool        readBusy;
+    bool        readEof;
+    bool        open;
+} UARTObject;
+
+static UARTObject objects[CONFIG_TI_DRIVERS_UART_COUNT];
+static UART_Config configs[CONFIG_TI_DRIVERS_UART_COUNT];
+
+/*
+ *  ======== wireTimeUs ========
+ *  8N1 framing: ten bit times per byte.
+ */
+static uint64_t wireTimeUs(const UARTObject *object, size_t size) {
+    uint32_t baud = object->params.baudRate ? object->params.baudRate : 115200;
+
+    return ((uint64_t)size * 10u * 1000000u + baud - 1) / baud;
+}
+
+/*
+ *  ======== wireBytes ========
+ *  Bytes actually transmitted for a write, after text mode translation.
+ */
+static size_t wireBytes(const UARTObject *object, const void *buffer, size_t size) {
+    const char *p = buffer;
+    size_t count = size;
+    size_t i;
+
+    if (object->params.writeDataMode == UART_DATA_TEXT) {
+        for (i = 0; i < size; i++) {
+            count += (p[i] == '\n');
+        }
+    }
+    return count;
+}
+
+/*
+ *  ======== writeAll ========
+ */
+static bool writeAll(const char *p, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(1, p, size);
+
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+/*
+ *  ======== emit ========
+ *  Put the bytes on stdout and account for them.
+ */
+static bool emit(UARTObject *object, const void *buffer, size_t size) {
+    const char *p = buffer;
+    size_t start = 0, i;
+
+    HostSim_counters.uartWrites++;
+    HostSim_counters.uartBytesOut += wireBytes(object, buffer, size);
+    HostSim_counters.uartWireUs += wireTimeUs(object, wireBytes(object, buffer, size));
+
+    if (object->params.writeDataMode != UART_DATA_TEXT) {
+        return writeAll(p, size);
+    }
+    for (i = 0; i < size; i++) {
+        if (p[i] == '\n') {
+            if (!writeAll(p + start, i - start) || !writeAll("\r", 1)) {
+                return false;
+            }
+            start = i;
+        }
+    }
+    return writeAll(p + start, size - start);
+}
+
+/*
+ *  ======== writeDoneFxn ========
+ *  Interrupt body: the bytes of a callback-mode write have left the wire.
+ */
+static void writeDoneFxn(uintptr_t arg) {
+    UART_Config *config = (UART_Config *)arg;
+    UARTObject *object = config->object;
+    const void *buf = object->writeBuf;
+    size_t size = object->writeSize;
+
+    emit(object, buf, size);
+    object->writeBusy = false;
+    object->params.writeCallback((UART_Handle)config, (void *)buf, size);
+}
+
+/*
+ *  ======== readFxn ========
+ *  Interrupt body for callback-mode reads: raised by the wire time after
+ *  UART_read() and by input arriving on stdin.
+ */
+static void readFxn(uintptr_t arg) {
+    UART_Config *config = (UART_Config *)arg;
+    UARTObject *object = config->object;
+    struct pollfd pfd;
+    ssize_t n;
+
+    if (!object->readBusy) {
+        return;
+    }
+    pfd.fd = 0;
+    pfd.events = POLLIN;
+    while (object->readDone < object->readSize && poll(&pfd, 1, 0) == 1) {
+        n = read(0, (char *)object->readBuf + object->readDone, object->readSize - object->readDone);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            object->readEof = true;  /* Nothing more will come; leave the read pending */
+            return;
+        }
+        object->readDone += (size_t)n;
+    }
+    if (object->readDone < object->readSize) {
+        return;  /* Wait for the next input signal */
+    }
+    object->readBusy = false;
+    object->params.readCallback((UART_Handle)config, object->readBuf, object->readDone);
+}
+
+void UART_init(void) {
+}
+
+void UART_Params_init(UART_Params *params) {
+    params->readMode = UART_MODE_BLOCKING;
+    params->writeMode = UART_MODE_BLOCKING;
+    params->readTimeout = UART_WAIT_FOREVER;
+    params->writeTimeout = UART_WAIT_FOREVER;
+    params->readCallback = NULL;
+    params->writeCallback = NULL;
+    params->readReturnMode = UART_RETURN_NEWLINE;
+    params->readDataMode = UART_DATA_TEXT;
+    params->writeDataMode = UART_DATA_TEXT;
+    params->readEcho = UART_ECHO_ON;
+    params->baudRate = 115200;
+    params->dataLength = UART_LEN_8;
+    params->stopBits = UART_STOP_ONE;
+    params->parityType = UART_PAR_NONE;
+    params->custom = NULL;
+}
+
+/*
+ *  ======== UART_open ========
+ *  Reads and writes may each be blocking or use callback mode.
+ */
+UART_Handle UART_open(uint_least8_t index, UART_Params *params) {
+    UART_Params defaults;
+
+    if (index >= CONFIG_TI_DRIVERS_UART_COUNT || objects[index].open) {
+        return NULL;
+    }
+    if (params == NULL) {
+        UART_Params_init(&defaults);
+        params = &defaults;
+    }
+    if ((params->readMode == UART_MODE_CALLBACK && params->readCallback == NULL) ||
+        (params->writeMode == UART_MODE_CALLBACK && params->writeCallback == NULL)) {
+        return NULL;
+    }
+
+    objects[index].params = *params;
+    objects[index].writeBusy = false;
+    objects[index].readBusy = false;
+    objects[index].readEof = false;
+    objects[index].open = true;
+    configs[index].object = &objects[index];
+    HostSim_irqCreate(&objects[index].writeIrq, HostSim_IRQ_UART, writeDoneFxn,
+                      (uintptr_t)&configs[index]);
+    if (params->readMode == UART_MODE_CALLBACK) {
+        HostSim_irqCreate(&objects[index].readIrq, HostSim_IRQ_UART, readFxn,
+                          (uintptr_t)&configs[index]);
+        HostSim_irqWatchFd(&objects[index].readIrq, 0);
+    }
+    return (UART_Handle)&configs[index];
+}
+
+void UART_close(UART_Handle handle) {
+    ((UARTObject *)handle->object)->open = false;
+}
+
+int_fast16_t UART_control(UART_Handle handle, uint_fast16_t cmd, void *arg) {
+    (void)handle;
+    (void)cmd;
+    (void)arg;
+    return UART_STATUS_UNDEFINEDCMD;
+}
+
+/*
+ *  ======== UART_read ========
+ *  Once stdin is exhausted a blocking caller stays blocked, servicing
+ *  interrupts, until the run ends; a callback-mode read never completes.
+ */
+int_fast32_t UART_read(UART_Handle handle, void *buffer, size_t size) {
+    UARTObject *object = handle->object;
+    size_t done = 0;
+    sigset_t none;
+
+    HostSim_counters.uartReads++;
+    if (object->params.readMode == UART_MODE_CALLBACK) {
+        uintptr_t key = HwiP_disable();
+
+        if (object->readBusy) {
+            HwiP_restore(key);
+            return UART_STATUS_ERROR;
+        }
+        object->readBusy = true;
+        object->readBuf = buffer;
+        object->readSize = size;
+        object->readDone = 0;
+        if (!object->readEof) {
+            HostSim_irqArm(&object->readIrq, wireTimeUs(object, size), 0);
+        }
+        HwiP_restore(key);
+        return 0;
+    }
+    while (done < size) {
+        ssize_t n = read(0, (char *)buffer + done, size - done);
+
+        if (n > 0) {
+            done += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            sigemptyset(&none);
+            for (;;) {
+                sigsuspend(&none);
+            }
+        }
+    }
+    return (int_fast32_t)done;
+}
+
+/*
+ *  ======== UART_readCancel ========
+ */
+void UART_readCancel(UART_Handle handle) {
+    UARTObject *object = handle->object;
+
+    if (object->readBusy) {
+        HostSim_irqDisarm(&object->readIrq);
+        object->readBusy = false;
+        object->params.readCallback(handle, object->readBuf, object->readDone);
+    }
+}
+
+/*
+ *  ======== UART_write ========
+ *  In callback mode only one write may be outstanding, as in the driver.
+ */
+int_fast32_t UART_write(UART_Handle handle, const void *buffer, size_t size) {
+    UARTObject *object = handle->object;
+    uint64_t wireUs = wireTimeUs(object, wireBytes(object, buffer, size));
+
+    if (object->params.writeMode == UART_MODE_CALLBACK) {
+        uintptr_t key = HwiP_disable();
+
+        if (object->writeBusy) {
+            HwiP_restore(key);
+            return UART_STATUS_ERROR;
+        }
+        object->writeBusy = true;
+        object->writeBuf = buffer;
+        object->writeSize = size;
+        HostSim_irqArm(&object->writeIrq, wireUs, 0);
+        HwiP_restore(key);
+        return 0;
+    }
+
+    if (!emit(object, buffer, size)) {
+        return UART_STATUS_ERROR;
+    }
+    if (HostSim_modelBus()) {
+        HostSim_sleepUs(wireUs);
+    }
+    return (int_fast32_t)size;
+}
+
+/*
+ *  ======== UART_writeCancel ========
+ */
+void UART_writeCancel(UART_Handle handle) {
+    UARTObject *object = handle->object;
+
+    if (object->writeBusy) {
+        HostSim_irqDisarm(&object->writeIrq);
+        object->writeBusy = false;
+        object->params.writeCallback(handle, (void *)object->writeBuf, 0);
+    }
+}
+
+/*
+ *  ======== UART_writePolling ========
+ */
+int_fast32_t UART_writePolling(UART_Handle handle, const void *buffer, size_t size) {
+    UARTObject *object = handle->object;
+
+    if (!emit(object, buffer, size)) {
+        return UART_STATUS_ERROR;
+    }
+    if (HostSim_modelBus()) {
+        HostSim_sleepUs(wireTimeUs(object, wireBytes(object, buffer, size)));
+    }
+    return (int_fast32_t)size;
+}
@@ -0,0 +1,50 @@
+/*
+ *  ======== dpl.c ========
+ *  Host stand-in for HwiP. Interrupts are disabled by blocking the HostSim
+ *  interrupt signal on the calling thread.
+ */
+
+#include <signal.h>
+
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "HostSim.h"
+
+/*
+ *  ======== HwiP_disable ========
+ *  Returns nonzero if interrupts were already disabled.
+ */
+uintptr_t HwiP_disable(void) {
+    sigset_t set, old;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGRTMIN);
+    sigprocmask(SIG_BLOCK, &set, &old);
+    return sigismember(&old, SIGRTMIN) ? 1 : 0;
+}
+
+void HwiP_enable(void) {
+    sigset_t set;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGRTMIN);
+    sigprocmask(SIG_UNBLOCK, &set, NULL);
+}
+
+/*
+ *  ======== HwiP_inISR ========
+ *  The signal is blocked for the duration of the handler, so being blocked
+ *  is the closest host equivalent of IPSR != 0.
+ */
+bool HwiP_inISR(void) {
+    sigset_t current;
+
+    sigprocmask(SIG_BLOCK, NULL, &current);
+    return sigismember(&current, SIGRTMIN);
+}
+
+void HwiP_restore(uintptr_t key) {
+    if (key == 0) {
+        HwiP_enable();
+    }
+}
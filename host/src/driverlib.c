@@ -0,0 +1,57 @@
+/*
+ *  ======== driverlib.c ========
+ *  Host stand-ins for the CC32xx driverlib CPU and PRCM calls.
+ */
+
+#include <signal.h>
+
+#include <ti/devices/cc32xx/inc/hw_types.h>
+#include <ti/devices/cc32xx/driverlib/cpu.h>
+#include <ti/devices/cc32xx/driverlib/prcm.h>
+
+#include "HostSim.h"
+
+unsigned long CPUcpsid(void) {
+    sigset_t set, old;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGRTMIN);
+    sigprocmask(SIG_BLOCK, &set, &old);
+    return sigismember(&old, SIGRTMIN) ? 1 : 0;
+}
+
+unsigned long CPUcpsie(void) {
+    sigset_t set, old;
+
+    sigemptyset(&set);
+    sigaddset(&set, SIGRTMIN);
+    sigprocmask(SIG_UNBLOCK, &set, &old);
+    return sigismember(&old, SIGRTMIN) ? 1 : 0;
+}
+
+/*
+ *  ======== CPUwfi ========
+ *  Like WFI, wakes on a pending interrupt even when interrupts are masked;
+ *  the handler runs before this returns. Time asleep is counted as idle.
+ */
+void CPUwfi(void) {
+    sigset_t wake;
+    uint64_t start = HostSim_nowUs();
+
+    sigprocmask(SIG_BLOCK, NULL, &wake);
+    sigdelset(&wake, SIGRTMIN);
+    HostSim_counters.wfiSinceUs = start ? start : 1;
+    sigsuspend(&wake);
+    HostSim_counters.wfiSinceUs = 0;
+
+    HostSim_counters.wfiCount++;
+    HostSim_counters.idleUs += HostSim_nowUs() - start;
+}
+
+unsigned long long PRCMSlowClkCtrGet(void) {
+    return HostSim_nowUs() * 32768u / 1000000u;
+}
+
+unsigned long long PRCMSlowClkCtrFastGet(void) {
+    return PRCMSlowClkCtrGet();
+}
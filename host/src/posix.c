@@ -0,0 +1,19 @@
+/*
+ *  ======== posix.c ========
+ *  Host replacements for the NoRTOS POSIX layer. usleep() runs on the
+ *  HostSim virtual clock so HOST_TIME_SCALE also speeds up pwmled2.
+ */
+
+#include <unistd.h>
+
+#include "HostSim.h"
+
+int usleep(useconds_t usec) {
+    HostSim_sleepUs(usec);
+    return 0;
+}
+
+unsigned int sleep(unsigned int seconds) {
+    HostSim_sleepUs((uint64_t)seconds * 1000000u);
+    return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ *  ======== simplelink.c ========
+ *  Host stand-in for the SimpleLink network processor file system. Each
+ *  serial flash file is a regular file in HOST_FS_DIR, named after the
+ *  flash path with '/' replaced by '_'. The network processor itself is
+ *  not modelled: sl_Start() and sl_Stop() only gate access to the files.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ti/drivers/net/wifi/simplelink.h>
+
+#include "HostSim.h"
+
+#define PATH_MAX_LEN 256
+
+static bool started = false;
+
+/*
+ *  ======== hostPath ========
+ */
+static void hostPath(const _u8 *name, char *path, size_t size) {
+    const char *dir = getenv("HOST_FS_DIR");
+    size_t n, i;
+
+    if (dir == NULL || *dir == '\0') {
+        dir = "hostfs";
+    }
+    mkdir(dir, 0777);
+    n = (size_t)snprintf(path, size, "%s/", dir);
+    for (i = 0; name[i] != '\0' && n + 1 < size; i++) {
+        path[n++] = (name[i] == '/') ? '_' : (char)name[i];
+    }
+    path[n] = '\0';
+}
+
+_i32 sl_Start(const void *pIfHdl, _i8 *pDevName, const P_INIT_CALLBACK pInitCallBack) {
+    (void)pIfHdl;
+    (void)pDevName;
+    (void)pInitCallBack;
+    started = true;
+    return ROLE_STA;
+}
+
+_i16 sl_Stop(const _u16 timeout) {
+    (void)timeout;
+    started = false;
+    return 0;
+}
+
+/*
+ *  ======== sl_FsOpen ========
+ */
+_i32 sl_FsOpen(const _u8 *pFileName, const _u32 accessModeAndMaxSize, _u32 *pToken) {
+    char path[PATH_MAX_LEN];
+    int flags;
+    int fd;
+
+    (void)pToken;
+    if (!started) {
+        return -1;
+    }
+    switch ((accessModeAndMaxSize >> 12) & 0x3) {
+        case 0:  flags = O_RDONLY; break;
+        case 1:  flags = O_WRONLY; break;
+        default: flags = O_WRONLY | O_CREAT | O_TRUNC; break;
+    }
+    hostPath(pFileName, path, sizeof(path));
+    fd = open(path, flags, 0666);
+    if (fd < 0) {
+        return (errno == ENOENT) ? SL_ERROR_FS_FILE_NOT_EXISTS : -1;
+    }
+    return fd;
+}
+
+_i16 sl_FsClose(const _i32 fileHdl, const _u8 *pCeritificateFileName,
+                const _u8 *pSignature, const _u32 signatureLen) {
+    (void)pCeritificateFileName;
+    (void)pSignature;
+    (void)signatureLen;
+    return (close(fileHdl) == 0) ? 0 : -1;
+}
+
+_i32 sl_FsRead(const _i32 fileHdl, _u32 offset, _u8 *pData, _u32 len) {
+    ssize_t n = pread(fileHdl, pData, len, offset);
+
+    return (n < 0) ? SL_ERROR_FS_FAILED_TO_READ : (_i32)n;
+}
+
+_i32 sl_FsWrite(const _i32 fileHdl, _u32 offset, _u8 *pData, _u32 len) {
+    ssize_t n = pwrite(fileHdl, pData, len, offset);
+
+    return (n < 0) ? SL_ERROR_FS_FAILED_TO_WRITE : (_i32)n;
+}
+
+_i16 sl_FsDel(const _u8 *pFileName, const _u32 token) {
+    char path[PATH_MAX_LEN];
+
+    (void)token;
+    hostPath(pFileName, path, sizeof(path));
+    return (unlink(path) == 0) ? 0 : SL_ERROR_FS_FILE_NOT_EXISTS;
+}
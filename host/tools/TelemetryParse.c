@@ -0,0 +1,97 @@
+/*
+ *  ======== TelemetryParse.c ========
+ */
+
+#include "TelemetryParse.h"
+
+/*
+ *  ======== digits ========
+ *  Unsigned decimal at p. *count is the number of digits read; the caller
+ *  rejects counts and values out of range for the field.
+ */
+static const char *digits(const char *p, uint64_t *value, uint32_t *count) {
+    const char *start = p;
+    uint64_t v = 0;
+    uint32_t d;
+
+    while ((d = (uint32_t)(unsigned char)*p - '0') < 10) {
+        v = v * 10 + d;
+        p++;
+    }
+    *value = v;
+    *count = (uint32_t)(p - start);
+    return p;
+}
+
+/*
+ *  ======== TelemetryParse_line ========
+ *  Parse the line [line, end), with any trailing "\r" already removed.
+ *  The bytes from end up to end + TelemetryParse_LOOKAHEAD must be
+ *  readable.
+ */
+TelemetryParse_Result TelemetryParse_line(const char *line, const char *end,
+                                          TelemetryParse_Record *record) {
+    const char *p = line;
+    uint32_t bad = 0;
+    uint64_t whole, setPoint, time, zone;
+    uint32_t negative, frac, heater, count, hasZone;
+    uint32_t d0, d1, d2;
+    int32_t q7;
+
+    if (p == end || *p != '<') {
+        return TelemetryParse_OTHER;
+    }
+    p++;
+
+    /* RoomTemp: [-]D.DDD */
+    negative = (*p == '-');
+    p += negative;
+    p = digits(p, &whole, &count);
+    bad |= (count - 1) > 3;
+    bad |= (*p != '.');
+    d0 = (uint32_t)(unsigned char)p[1] - '0';
+    d1 = (uint32_t)(unsigned char)p[2] - '0';
+    d2 = (uint32_t)(unsigned char)p[3] - '0';
+    bad |= (d0 > 9) | (d1 > 9) | (d2 > 9);
+    frac = d0 * 100 + d1 * 10 + d2;
+    p += 4;
+    bad |= (*p++ != ',');
+
+    /* SetPoint: [-]D+ */
+    negative |= (uint32_t)(*p == '-') << 1;
+    p += (negative >> 1);
+    p = digits(p, &setPoint, &count);
+    bad |= ((count - 1) > 4) | (setPoint > INT16_MAX);
+    bad |= (*p++ != ',');
+
+    /* HeaterStatus: 0 or 1 */
+    heater = (uint32_t)(unsigned char)*p++ - '0';
+    bad |= heater > 1;
+    bad |= (*p++ != ',');
+
+    /* TimeCounter, then the zone for any zone but 0 */
+    p = digits(p, &time, &count);
+    bad |= ((count - 1) > 9) | (time > UINT32_MAX);
+    hasZone = (*p == ',');
+    p += hasZone;
+    p = digits(p, &zone, &count);
+    bad |= hasZone & ((count - 1) > 1);  /* No digits follow the time counter otherwise */
+    bad |= zone > 15;
+    bad |= (*p++ != '>');
+    bad |= (p != end);
+
+    /* Every Q7 value has a distinct three-decimal rendering, so rounding recovers it exactly */
+    q7 = (int32_t)(((whole * 1000 + frac) * 128 + 500) / 1000);
+    bad |= q7 > INT16_MAX;
+
+    if (bad) {
+        return TelemetryParse_MALFORMED;
+    }
+
+    record->temperature = (int16_t)((negative & 1) ? -q7 : q7);
+    record->setPoint = (int16_t)((negative & 2) ? -(int32_t)setPoint : (int32_t)setPoint);
+    record->heaterOn = (uint8_t)heater;
+    record->timeCounter = time;
+    record->zone = (uint8_t)zone;
+    return TelemetryParse_RECORD;
+}
@@ -0,0 +1,39 @@
+/*
+ *  ======== TelemetryParse.h ========
+ *  Parser for the thermostat's ASCII telemetry lines,
+ *      <RoomTemp,SetPoint,HeaterStatus,TimeCounter[,Zone]>
+ *  as produced by Telemetry_MODE_ASCII.
+ *
+ *  The parser works in place on the receive buffer and allocates nothing.
+ *  Fields are read with straight-line digit loops, and every format check
+ *  is OR-ed into one error word that is tested once at the end, so a well
+ *  formed line takes no data-dependent branches beyond the digit loops.
+ */
+
+#ifndef TelemetryParse_h
+#define TelemetryParse_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Bytes the parser may read past the end of a line; receive buffers need this much slack */
+#define TelemetryParse_LOOKAHEAD    8
+
+typedef struct {
+    uint32_t timeCounter;   /* Seconds since the device reset */
+    int16_t  temperature;   /* Q7, 1/128 degree C, as on the device */
+    int16_t  setPoint;      /* Degrees C */
+    uint8_t  heaterOn;
+    uint8_t  zone;
+} TelemetryParse_Record;
+
+typedef enum {
+    TelemetryParse_RECORD,      /* *record holds the line's values */
+    TelemetryParse_OTHER,       /* Not a record line: boot text, command replies */
+    TelemetryParse_MALFORMED    /* Starts like a record but does not parse */
+} TelemetryParse_Result;
+
+extern TelemetryParse_Result TelemetryParse_line(const char *line, const char *end,
+                                                 TelemetryParse_Record *record);
+
+#endif /* TelemetryParse_h */
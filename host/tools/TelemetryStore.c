@@ -0,0 +1,347 @@
+/*
+ *  ======== TelemetryStore.c ========
+ *  Each device file is mapped once over its largest possible size, so
+ *  appending never remaps; the file itself grows a block at a time.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TelemetryStore.h"
+
+#define PAGE_SIZE       4096u
+#define HEADER_SIZE     PAGE_SIZE
+#define INDEX_SIZE      ((size_t)TelemetryStore_MAX_BLOCKS * sizeof(IndexEntry))
+#define DATA_OFFSET     (HEADER_SIZE + INDEX_SIZE)
+#define ROW_SIZE        9u      /* Bytes per row over all columns */
+#define BLOCK_SIZE      ((size_t)TelemetryStore_BLOCK_ROWS * ROW_SIZE)
+#define FILE_SPAN       (DATA_OFFSET + (size_t)TelemetryStore_MAX_BLOCKS * BLOCK_SIZE)
+
+/* Column offsets within a block */
+#define TIME_COLUMN     0
+#define TEMP_COLUMN     (4 * TelemetryStore_BLOCK_ROWS)
+#define SET_COLUMN      (6 * TelemetryStore_BLOCK_ROWS)
+#define FLAGS_COLUMN    (8 * TelemetryStore_BLOCK_ROWS)
+
+typedef struct {
+    uint32_t minTime;
+    uint32_t maxTime;
+} IndexEntry;
+
+typedef struct Device Device;
+
+struct Device {
+    int                    fd;
+    uint8_t               *base;        /* FILE_SPAN mapping of the file */
+    TelemetryStore_Header *header;
+    IndexEntry            *index;
+    uint64_t               rows;        /* Including rows not yet flushed */
+    uint64_t               fileBlocks;  /* Blocks the file has room for */
+    Device                *nextDirty;
+    bool                   dirty;
+};
+
+struct TelemetryStore {
+    char     *path;
+    Device  **devices;  /* TelemetryStore_MAX_DEVICES entries, opened on first use */
+    Device   *dirty;    /* Devices with rows appended since the last flush */
+    uint64_t  appended;
+};
+
+/*
+ *  ======== blockBase ========
+ */
+static uint8_t *blockBase(const Device *d, uint64_t block) {
+    return d->base + DATA_OFFSET + block * BLOCK_SIZE;
+}
+
+/*
+ *  ======== syncRange ========
+ *  Write back [offset, offset + size) of the mapping, widened to pages.
+ */
+static bool syncRange(const Device *d, size_t offset, size_t size) {
+    size_t start = offset & ~(size_t)(PAGE_SIZE - 1);
+
+    return msync(d->base + start, offset + size - start, MS_SYNC) == 0;
+}
+
+/*
+ *  ======== closeDevice ========
+ */
+static void closeDevice(Device *d) {
+    if (d->base != MAP_FAILED) {
+        munmap(d->base, FILE_SPAN);
+    }
+    close(d->fd);
+    free(d);
+}
+
+/*
+ *  ======== openDevice ========
+ *  Map the device's file, creating it if create is set. Returns NULL if
+ *  the file does not exist (and create is clear) or is not a valid store
+ *  file.
+ */
+static Device *openDevice(TelemetryStore *store, uint16_t device, bool create) {
+    char path[4096];
+    struct stat st;
+    TelemetryStore_Header *h;
+    Device *d;
+
+    if (store->devices[device] != NULL) {
+        return store->devices[device];
+    }
+
+    snprintf(path, sizeof(path), "%s/dev-%05u.tsc", store->path, (unsigned)device);
+    d = calloc(1, sizeof(*d));
+    if (d == NULL) {
+        return NULL;
+    }
+    d->base = MAP_FAILED;
+    d->fd = open(path, O_RDWR | (create ? O_CREAT : 0), 0644);
+    if (d->fd < 0 || fstat(d->fd, &st) != 0 ||
+        (st.st_size == 0 && (!create || ftruncate(d->fd, (off_t)DATA_OFFSET) != 0))) {
+        closeDevice(d);
+        return NULL;
+    }
+    d->base = mmap(NULL, FILE_SPAN, PROT_READ | PROT_WRITE, MAP_SHARED, d->fd, 0);
+    if (d->base == MAP_FAILED) {
+        closeDevice(d);
+        return NULL;
+    }
+    h = d->header = (TelemetryStore_Header *)d->base;
+    d->index = (IndexEntry *)(d->base + HEADER_SIZE);
+
+    if (st.st_size == 0) {
+        h->version = TelemetryStore_VERSION;
+        h->device = device;
+        h->blockRows = TelemetryStore_BLOCK_ROWS;
+        h->maxBlocks = TelemetryStore_MAX_BLOCKS;
+        h->rows = 0;
+        h->magic = TelemetryStore_MAGIC;  /* Last, so a torn create is not a store */
+        if (!syncRange(d, 0, HEADER_SIZE)) {
+            closeDevice(d);
+            return NULL;
+        }
+        st.st_size = (off_t)DATA_OFFSET;
+    }
+
+    d->fileBlocks = ((uint64_t)st.st_size - DATA_OFFSET) / BLOCK_SIZE;
+    if ((uint64_t)st.st_size < DATA_OFFSET || h->magic != TelemetryStore_MAGIC ||
+        h->version != TelemetryStore_VERSION || h->device != device ||
+        h->blockRows != TelemetryStore_BLOCK_ROWS || h->maxBlocks != TelemetryStore_MAX_BLOCKS ||
+        h->rows > d->fileBlocks * TelemetryStore_BLOCK_ROWS) {
+        closeDevice(d);
+        return NULL;
+    }
+    d->rows = h->rows;  /* Rows appended after the last flush before a crash are dropped here */
+    store->devices[device] = d;
+    return d;
+}
+
+/*
+ *  ======== TelemetryStore_open ========
+ *  Open the store in directory path. With create, the directory is made
+ *  if needed; without it, a missing directory fails with ENOENT rather
+ *  than turning up as an empty store. Device files are opened as they are
+ *  first used.
+ */
+TelemetryStore *TelemetryStore_open(const char *path, bool create) {
+    TelemetryStore *store;
+    struct stat st;
+
+    if (create) {
+        if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+            return NULL;
+        }
+    } else if (stat(path, &st) != 0) {
+        return NULL;
+    } else if (!S_ISDIR(st.st_mode)) {
+        errno = ENOTDIR;
+        return NULL;
+    }
+    store = calloc(1, sizeof(*store));
+    if (store == NULL) {
+        return NULL;
+    }
+    store->path = strdup(path);
+    store->devices = calloc(TelemetryStore_MAX_DEVICES, sizeof(*store->devices));
+    if (store->path == NULL || store->devices == NULL) {
+        free(store->path);
+        free(store->devices);
+        free(store);
+        return NULL;
+    }
+    return store;
+}
+
+/*
+ *  ======== TelemetryStore_append ========
+ *  Returns false if the device file cannot be opened or grown, or is full.
+ */
+bool TelemetryStore_append(TelemetryStore *store, uint16_t device, const TelemetryParse_Record *record) {
+    Device *d = openDevice(store, device, true);
+    uint64_t block, row;
+    IndexEntry *entry;
+    uint8_t *base;
+
+    if (d == NULL || d->rows == (uint64_t)TelemetryStore_MAX_BLOCKS * TelemetryStore_BLOCK_ROWS) {
+        return false;
+    }
+    block = d->rows / TelemetryStore_BLOCK_ROWS;
+    row = d->rows % TelemetryStore_BLOCK_ROWS;
+    if (block >= d->fileBlocks) {
+        if (ftruncate(d->fd, (off_t)(DATA_OFFSET + (block + 1) * BLOCK_SIZE)) != 0) {
+            return false;
+        }
+        d->fileBlocks = block + 1;
+    }
+
+    entry = &d->index[block];
+    if (row == 0) {
+        entry->minTime = record->timeCounter;
+        entry->maxTime = record->timeCounter;
+    } else if (record->timeCounter < entry->minTime) {
+        entry->minTime = record->timeCounter;
+    } else if (record->timeCounter > entry->maxTime) {
+        entry->maxTime = record->timeCounter;
+    }
+
+    base = blockBase(d, block);
+    ((uint32_t *)(base + TIME_COLUMN))[row] = record->timeCounter;
+    ((int16_t *)(base + TEMP_COLUMN))[row] = record->temperature;
+    ((int16_t *)(base + SET_COLUMN))[row] = record->setPoint;
+    base[FLAGS_COLUMN + row] = (uint8_t)((record->zone << TelemetryStore_FLAG_ZONE_SHIFT) |
+                                         (record->heaterOn ? TelemetryStore_FLAG_HEATER : 0));
+    d->rows++;
+    store->appended++;
+
+    if (!d->dirty) {
+        d->dirty = true;
+        d->nextDirty = store->dirty;
+        store->dirty = d;
+    }
+    return true;
+}
+
+/*
+ *  ======== TelemetryStore_flush ========
+ *  Make every appended row durable: write back the blocks and index
+ *  entries they touched, then publish the row counts. Returns false if
+ *  any device could not be written; its rows stay unflushed and the
+ *  device stays dirty, so the next flush tries it again.
+ */
+bool TelemetryStore_flush(TelemetryStore *store) {
+    Device *d, *next, *failed = NULL;
+    uint64_t first, last;
+    bool ok = true, synced;
+
+    for (d = store->dirty; d != NULL; d = next) {
+        next = d->nextDirty;
+
+        first = d->header->rows / TelemetryStore_BLOCK_ROWS;
+        last = (d->rows - 1) / TelemetryStore_BLOCK_ROWS;
+        synced = syncRange(d, DATA_OFFSET + first * BLOCK_SIZE, (last - first + 1) * BLOCK_SIZE) &&
+                 syncRange(d, HEADER_SIZE + first * sizeof(IndexEntry), (last - first + 1) * sizeof(IndexEntry));
+        if (synced) {
+            d->header->rows = d->rows;  /* The commit point: one aligned 8-byte store */
+            synced = syncRange(d, 0, sizeof(TelemetryStore_Header));
+        }
+        if (synced) {
+            d->dirty = false;
+            d->nextDirty = NULL;
+        } else {
+            d->nextDirty = failed;
+            failed = d;
+            ok = false;
+        }
+    }
+    store->dirty = failed;
+    return ok;
+}
+
+/*
+ *  ======== TelemetryStore_count ========
+ *  Rows appended since the store was opened.
+ */
+uint64_t TelemetryStore_count(const TelemetryStore *store) {
+    return store->appended;
+}
+
+/*
+ *  ======== TelemetryStore_rows ========
+ *  Flushed rows of a device; 0 if it has no file.
+ */
+uint64_t TelemetryStore_rows(TelemetryStore *store, uint16_t device) {
+    Device *d = openDevice(store, device, false);
+
+    return d == NULL ? 0 : d->header->rows;
+}
+
+/*
+ *  ======== TelemetryStore_scan ========
+ *  Hand fxn, one block at a time, the flushed rows of device in every
+ *  block whose time span overlaps [from, to]. The blocks can also hold
+ *  rows outside the range; fxn filters on the time column. Returns false
+ *  if the device has no file.
+ */
+bool TelemetryStore_scan(TelemetryStore *store, uint16_t device, uint32_t from, uint32_t to,
+                         TelemetryStore_ScanFxn fxn, void *arg, TelemetryStore_ScanStats *stats) {
+    Device *d = openDevice(store, device, false);
+    TelemetryStore_Columns columns;
+    uint64_t rows, block, blocks;
+    const uint8_t *base;
+
+    if (d == NULL) {
+        return false;
+    }
+    rows = d->header->rows;
+    blocks = (rows + TelemetryStore_BLOCK_ROWS - 1) / TelemetryStore_BLOCK_ROWS;
+    stats->blocks += blocks;
+
+    for (block = 0; block < blocks; block++) {
+        if (d->index[block].maxTime < from || d->index[block].minTime > to) {
+            stats->blocksSkipped++;
+            continue;
+        }
+        base = blockBase(d, block);
+        columns.time = (const uint32_t *)(base + TIME_COLUMN);
+        columns.temperature = (const int16_t *)(base + TEMP_COLUMN);
+        columns.setPoint = (const int16_t *)(base + SET_COLUMN);
+        columns.flags = base + FLAGS_COLUMN;
+        columns.count = (size_t)(rows - block * TelemetryStore_BLOCK_ROWS);
+        if (columns.count > TelemetryStore_BLOCK_ROWS) {
+            columns.count = TelemetryStore_BLOCK_ROWS;
+        }
+        stats->rowsScanned += columns.count;
+        if (!fxn(arg, &columns)) {
+            break;
+        }
+    }
+    return true;
+}
+
+/*
+ *  ======== TelemetryStore_close ========
+ *  Flush and close; returns false if the last rows could not be written.
+ */
+bool TelemetryStore_close(TelemetryStore *store) {
+    bool ok = TelemetryStore_flush(store);
+    uint32_t i;
+
+    for (i = 0; i < TelemetryStore_MAX_DEVICES; i++) {
+        if (store->devices[i] != NULL) {
+            closeDevice(store->devices[i]);
+        }
+    }
+    free(store->devices);
+    free(store->path);
+    free(store);
+    return ok;
+}
@@ -0,0 +1,87 @@
+/*
+ *  ======== TelemetryStore.h ========
+ *  Append-only, memory-mapped columnar store for ingested telemetry.
+ *
+ *  A store is a directory holding one file per device, dev-NNNNN.tsc.
+ *  Rows are kept in blocks of TelemetryStore_BLOCK_ROWS, and within a
+ *  block each field is a contiguous column, so a scan of one field reads
+ *  only that field's pages:
+ *
+ *      offset              size        contents
+ *      0                   4096        header, TelemetryStore_Header
+ *      4096                8 * blocks  sparse time index, min and max
+ *                                      time counter of every block
+ *      data + k * block    4 * rows    time counter, uint32
+ *                          2 * rows    room temperature, int16 Q7
+ *                          2 * rows    set point, int16 degrees C
+ *                          1 * rows    flags, bit 0 = heater on, bits 7:4 = zone
+ *
+ *  Values are in host byte order. The time counter restarts when a
+ *  device resets, so the index keeps a minimum and maximum per block
+ *  rather than assuming time only grows; a range scan skips every block
+ *  whose span misses the range.
+ *
+ *  TelemetryStore_append() writes straight into the mapping. The rows
+ *  become part of the store at TelemetryStore_flush(), which writes the
+ *  data back to disk before it publishes the new row count in the
+ *  header. After a crash the store reopens at the last flush with no
+ *  replay: opening a device maps its file and reads the header.
+ */
+
+#ifndef TelemetryStore_h
+#define TelemetryStore_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "TelemetryParse.h"
+
+#define TelemetryStore_MAGIC        0x31435354u  /* "TSC1" */
+#define TelemetryStore_VERSION      1
+#define TelemetryStore_BLOCK_ROWS   4096
+#define TelemetryStore_MAX_BLOCKS   8192    /* 33.5M rows per device, a year at 1 record/s */
+#define TelemetryStore_MAX_DEVICES  65536
+
+#define TelemetryStore_FLAG_HEATER      0x01
+#define TelemetryStore_FLAG_ZONE_SHIFT  4
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t device;
+    uint32_t blockRows;
+    uint32_t maxBlocks;
+    uint64_t rows;          /* Rows in the store; anything past them is ignored */
+} TelemetryStore_Header;
+
+/* One block's rows within a scan: columns of count rows each */
+typedef struct {
+    const uint32_t *time;
+    const int16_t  *temperature;
+    const int16_t  *setPoint;
+    const uint8_t  *flags;
+    size_t          count;
+} TelemetryStore_Columns;
+
+typedef struct {
+    uint64_t blocks;        /* Blocks holding rows */
+    uint64_t blocksSkipped; /* Passed over on the time index */
+    uint64_t rowsScanned;   /* Rows handed to the callback */
+} TelemetryStore_ScanStats;
+
+/* Return false to end the scan */
+typedef bool (*TelemetryStore_ScanFxn)(void *arg, const TelemetryStore_Columns *columns);
+
+typedef struct TelemetryStore TelemetryStore;
+
+extern TelemetryStore *TelemetryStore_open(const char *path, bool create);
+extern bool TelemetryStore_append(TelemetryStore *store, uint16_t device, const TelemetryParse_Record *record);
+extern bool TelemetryStore_flush(TelemetryStore *store);
+extern uint64_t TelemetryStore_count(const TelemetryStore *store);
+extern uint64_t TelemetryStore_rows(TelemetryStore *store, uint16_t device);
+extern bool TelemetryStore_scan(TelemetryStore *store, uint16_t device, uint32_t from, uint32_t to,
+                                TelemetryStore_ScanFxn fxn, void *arg, TelemetryStore_ScanStats *stats);
+extern bool TelemetryStore_close(TelemetryStore *store);
+
+#endif /* TelemetryStore_h */
@@ -0,0 +1,105 @@
+/*
+ *  ======== morse_pack.c ========
+ *  Packs Morse messages at build time for the Morse project.
+ *
+ *      morse_pack text... > MorseMessages.h
+ *
+ *  Writes a header with each text packed by MorseCode_pack(), two bits
+ *  per symbol, as const data that stays in flash, and the table of
+ *  MorseCode_Message entries the firmware plays. A summary on stderr
+ *  compares the packed size with the one byte per element strings the
+ *  project used to store and with a table of (LED, duration) steps.
+ *
+ *      host/build/tools/morse_pack SOS OK > Morse_Code_Project/.../MorseMessages.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MorseCode.h"
+
+/*
+ *  ======== putText ========
+ *  text as a C string literal.
+ */
+static void putText(const char *text) {
+    putchar('"');
+    for (; *text != '\0'; text++) {
+        if (*text == '"' || *text == '\\') {
+            putchar('\\');
+        }
+        putchar(*text);
+    }
+    putchar('"');
+}
+
+int main(int argc, char *argv[]) {
+    uint8_t *bits;
+    size_t size, symbols, elements, i;
+    unsigned long totalText = 0, totalPacked = 0;
+    int m;
+
+    if (argc < 2) {
+        fprintf(stderr, "usage: morse_pack text... > MorseMessages.h\n");
+        return 2;
+    }
+
+    printf("/*\n");
+    printf(" *  ======== MorseMessages.h ========\n");
+    printf(" *  Morse messages packed by host/tools/morse_pack; regenerate rather than edit:\n");
+    printf(" *\n");
+    printf(" *      morse_pack");
+    for (m = 1; m < argc; m++) {
+        printf(" ");
+        putText(argv[m]);
+    }
+    printf(" > MorseMessages.h\n");
+    printf(" */\n\n");
+    printf("#ifndef MorseMessages_h\n#define MorseMessages_h\n\n#include \"MorseCode.h\"\n\n");
+
+    for (m = 1; m < argc; m++) {
+        size = MorseCode_PACKED_SIZE(strlen(argv[m]));
+        bits = malloc(size);
+        symbols = bits == NULL ? 0 : MorseCode_pack(argv[m], bits, size);
+        if (symbols == 0) {
+            fprintf(stderr, "morse_pack: \"%s\" has no Morse characters\n", argv[m]);
+            return 1;
+        }
+        for (i = 0, elements = 0; i < symbols; i++) {
+            elements += MorseCode_symbol(bits, i) <= MorseCode_DASH;
+        }
+
+        printf("/* ");
+        putText(argv[m]);
+        printf(": %zu symbols in %zu bytes */\n", symbols, (symbols + 3) / 4);
+        printf("static const uint8_t MorseMessages_bits%d[] = {", m - 1);
+        for (i = 0; i < (symbols + 3) / 4; i++) {
+            printf("%s0x%02x", i % 12 == 0 ? "\n    " : " ", bits[i]);
+            printf("%s", i + 1 < (symbols + 3) / 4 ? "," : "\n");
+        }
+        printf("};\n\n");
+
+        fprintf(stderr, "morse_pack: \"%s\": %zu elements, %zu symbols, packed %zu bytes; "
+                "dot-dash string %zu bytes, (LED, duration) steps %zu bytes\n",
+                argv[m], elements, symbols, (symbols + 3) / 4, elements + 1, 2 * elements * 8);
+        totalText += elements + 1;
+        totalPacked += (symbols + 3) / 4;
+        free(bits);
+    }
+
+    printf("static const MorseCode_Message MorseMessages_table[] = {\n");
+    for (m = 1; m < argc; m++) {
+        bits = malloc(MorseCode_PACKED_SIZE(strlen(argv[m])));
+        symbols = MorseCode_pack(argv[m], bits, MorseCode_PACKED_SIZE(strlen(argv[m])));
+        printf("    { ");
+        putText(argv[m]);
+        printf(", MorseMessages_bits%d, %zu },\n", m - 1, symbols);
+        free(bits);
+    }
+    printf("};\n\n#endif /* MorseMessages_h */\n");
+
+    fprintf(stderr, "morse_pack: %d messages, %lu bytes packed, %.1fx smaller than dot-dash strings\n",
+            argc - 1, totalPacked, (double)totalText / totalPacked);
+    return 0;
+}
@@ -0,0 +1,277 @@
+/*
+ *  ======== telemetry_decode.c ========
+ *  Decodes the thermostat's binary and delta telemetry (Telemetry_MODE_BINARY
+ *  and Telemetry_MODE_DELTA) from stdin and prints each record in the ASCII
+ *  telemetry format, one line per record also for batch frames. Frames that
+ *  fail COBS, length, version or CRC checks are counted and skipped, which
+ *  also discards any boot text preceding the first frame.
+ *
+ *  The decoder streams: each frame is printed as soon as its delimiter
+ *  arrives. Delta packets are applied to the last record of their zone; a
+ *  sequence gap drops that state, and deltas are then counted as skipped
+ *  until the zone's next keyframe.
+ *
+ *      host/build/thermostat | host/build/tools/telemetry_decode
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Telemetry.h"
+#include "TempConv.h"
+
+#define MAX_FRAME   256
+
+typedef struct {
+    unsigned long frames;
+    unsigned long records;
+    unsigned long badFrames;
+    unsigned long lost;
+    unsigned long skipped;  /* Deltas that arrived without a keyframe to apply to */
+} DecodeStats;
+
+/* Last record of each zone, the reference for its next delta */
+typedef struct {
+    Telemetry_Record last;
+    bool             valid;
+} ZoneState;
+
+static ZoneState zones[Telemetry_MAX_ZONES];
+
+/*
+ *  ======== cobsDecode ========
+ *  Returns the decoded length, or -1 if the encoding is invalid.
+ */
+static int cobsDecode(const uint8_t *src, size_t len, uint8_t *dst) {
+    size_t in = 0, out = 0;
+
+    while (in < len) {
+        uint8_t code = src[in++];
+        uint8_t i;
+
+        if (code == 0 || in + code - 1 > len) {
+            return -1;
+        }
+        for (i = 1; i < code; i++) {
+            dst[out++] = src[in++];
+        }
+        if (code != 0xFF && in < len) {
+            dst[out++] = 0;
+        }
+    }
+    return (int)out;
+}
+
+static uint16_t getLe16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t getLe32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*
+ *  ======== getRecord ========
+ *  One Telemetry_RECORD_LEN record from a sample, batch or keyframe packet.
+ */
+static void getRecord(const uint8_t *p, Telemetry_Record *record) {
+    record->roomTemperature = (int16_t)getLe16(p);
+    record->setPoint = (int16_t)getLe16(p + 2);
+    record->heaterOn = (p[4] & Telemetry_FLAG_HEATER) != 0;
+    record->zone = p[4] >> Telemetry_FLAG_ZONE_SHIFT;
+    record->timeCounter = getLe32(p + 5);
+}
+
+/*
+ *  ======== getVarint ========
+ *  Returns false if the varint runs past end or beyond 32 bits.
+ */
+static bool getVarint(const uint8_t **p, const uint8_t *end, uint32_t *value) {
+    uint32_t result = 0;
+    unsigned shift;
+
+    for (shift = 0; shift < 35 && *p < end; shift += 7) {
+        uint8_t byte = *(*p)++;
+
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ *  ======== applyDelta ========
+ *  Parse the fields of a delta packet (header and sequence already
+ *  checked, check byte removed) into record. Returns false if the packet
+ *  is malformed.
+ */
+static bool applyDelta(const uint8_t *packet, size_t len, Telemetry_Record *record, bool *known) {
+    const uint8_t *p = packet + 2;
+    const uint8_t *end = packet + len;
+    uint8_t mask = packet[0] & Telemetry_DELTA_MASK;
+    uint32_t value, zone = 0;
+    const ZoneState *state;
+
+    if ((mask & Telemetry_DELTA_ZONE) && (!getVarint(&p, end, &zone) || zone >= Telemetry_MAX_ZONES)) {
+        return false;
+    }
+    state = &zones[zone];
+    *record = state->last;
+    *known = state->valid;
+    if (mask & Telemetry_DELTA_TEMP) {
+        if (!getVarint(&p, end, &value)) {
+            return false;
+        }
+        record->roomTemperature = (TempConv_Q7)(record->roomTemperature + Telemetry_unzigzag(value));
+    }
+    if (mask & Telemetry_DELTA_SET_POINT) {
+        if (!getVarint(&p, end, &value)) {
+            return false;
+        }
+        record->setPoint += Telemetry_unzigzag(value);
+    }
+    if (mask & Telemetry_DELTA_HEATER) {
+        record->heaterOn = !record->heaterOn;
+    }
+    value = 1;
+    if ((mask & Telemetry_DELTA_TIME) && !getVarint(&p, end, &value)) {
+        return false;
+    }
+    record->timeCounter += value;
+    record->zone = (uint8_t)zone;
+    return p == end;
+}
+
+/*
+ *  ======== printRecord ========
+ *  One record as an ASCII telemetry line.
+ */
+static void printRecord(const Telemetry_Record *record) {
+    char tempText[TempConv_FORMAT_LEN];
+
+    TempConv_format(tempText, record->roomTemperature);
+    printf("<%s,%02d,%d,%04u", tempText, record->setPoint, record->heaterOn ? 1 : 0,
+           (unsigned)record->timeCounter);
+    if (record->zone != 0) {
+        printf(",%u", (unsigned)record->zone);
+    }
+    printf(">\n");
+}
+
+/*
+ *  ======== checkSequence ========
+ *  Count the frames lost before this one. Any loss may have taken a delta,
+ *  so every zone waits for a keyframe.
+ */
+static void checkSequence(uint8_t sequence, DecodeStats *stats) {
+    static int lastSequence = -1;
+    uint8_t gap;
+    unsigned i;
+
+    if (lastSequence >= 0) {
+        gap = (uint8_t)(sequence - lastSequence - 1);
+        if (gap != 0) {
+            stats->lost += gap;
+            for (i = 0; i < Telemetry_MAX_ZONES; i++) {
+                zones[i].valid = false;
+            }
+        }
+    }
+    lastSequence = sequence;
+    stats->frames++;
+}
+
+/*
+ *  ======== handleFrame ========
+ */
+static void handleFrame(const uint8_t *frame, size_t len, DecodeStats *stats) {
+    uint8_t packet[MAX_FRAME];
+    Telemetry_Record record;
+    unsigned count, i;
+    bool known;
+    int n;
+
+    if (len == 0) {
+        return;  /* Resync delimiter */
+    }
+    n = cobsDecode(frame, len, packet);
+    if (n >= 3 && (packet[0] & ~Telemetry_DELTA_MASK) == Telemetry_DELTA_HEADER) {
+        if (packet[n - 1] != (uint8_t)Telemetry_crc16(packet, (size_t)n - 1) ||
+            !applyDelta(packet, (size_t)n - 1, &record, &known)) {
+            stats->badFrames++;
+            return;
+        }
+        checkSequence(packet[1], stats);
+        if (!known || !zones[record.zone].valid) {
+            stats->skipped++;
+            return;
+        }
+        zones[record.zone].last = record;
+        stats->records++;
+        printRecord(&record);
+        return;
+    }
+
+    if (n == Telemetry_PAYLOAD_LEN && (packet[0] == ((Telemetry_VERSION << 4) | Telemetry_TYPE_SAMPLE) ||
+                                       packet[0] == ((Telemetry_VERSION << 4) | Telemetry_TYPE_KEYFRAME))) {
+        count = 1;
+    } else if (n >= 3 && packet[0] == ((Telemetry_VERSION << 4) | Telemetry_TYPE_BATCH) &&
+               packet[2] >= 1 && packet[2] <= Telemetry_BATCH_MAX_RECORDS &&
+               n == Telemetry_BATCH_PAYLOAD_LEN(packet[2])) {
+        count = packet[2];
+    } else {
+        stats->badFrames++;
+        return;
+    }
+    if (Telemetry_crc16(packet, (size_t)n - 2) != getLe16(packet + n - 2)) {
+        stats->badFrames++;
+        return;
+    }
+
+    checkSequence(packet[1], stats);
+    for (i = 0; i < count; i++) {
+        getRecord(packet + n - 2 - (count - i) * Telemetry_RECORD_LEN, &record);
+        if (packet[0] == ((Telemetry_VERSION << 4) | Telemetry_TYPE_KEYFRAME)) {
+            zones[record.zone].last = record;
+            zones[record.zone].valid = true;
+        }
+        stats->records++;
+        printRecord(&record);
+    }
+}
+
+int main(void) {
+    uint8_t frame[MAX_FRAME];
+    DecodeStats stats = { 0, 0, 0, 0, 0 };
+    size_t len = 0;
+    unsigned long bytes = 0;
+    bool overflow = false;
+    int c;
+
+    while ((c = getchar()) != EOF) {
+        bytes++;
+        if (c != 0) {
+            if (len < sizeof(frame)) {
+                frame[len++] = (uint8_t)c;
+            } else {
+                overflow = true;
+            }
+            continue;
+        }
+        if (overflow) {
+            stats.badFrames++;
+        } else {
+            handleFrame(frame, len, &stats);
+            fflush(stdout);
+        }
+        len = 0;
+        overflow = false;
+    }
+
+    fprintf(stderr, "telemetry_decode: %lu records in %lu frames (%lu bytes), %lu rejected, %lu lost (sequence gaps), %lu deltas skipped\n",
+            stats.records, stats.frames, bytes, stats.badFrames, stats.lost, stats.skipped);
+    return 0;
+}
@@ -0,0 +1,324 @@
+/*
+ *  ======== telemetry_ingest.c ========
+ *  Receives the ASCII telemetry of many thermostats and appends every
+ *  record to a TelemetryStore.
+ *
+ *      telemetry_ingest [-o store] [-i seconds] [-c seconds] device...
+ *
+ *  Each device is a serial port, a pty or a pipe ("-" for stdin); its
+ *  position on the command line is the device number kept with its
+ *  records. Serial ports and ptys are put in raw mode at 115200 baud.
+ *
+ *  One thread serves all streams from an epoll loop. Every stream has a
+ *  fixed receive buffer that lines are parsed from in place, so a record
+ *  costs no allocation and no copy before it reaches the store buffer.
+ *  Lines that are not records (boot text, command replies) are counted
+ *  and skipped. The store (default telemetry.store) is flushed every
+ *  commit interval (-c, default 1 s), which bounds what a crash can lose.
+ *
+ *  Every interval (default 5 s) and at exit a report on stderr gives the
+ *  record and byte rates, the parse cost per record and the latency from
+ *  epoll_wait() returning to each record being in the store, as a log2
+ *  histogram summary. SIGINT or SIGTERM, or every stream reaching end of
+ *  file, ends the run.
+ *
+ *      host/build/tools/telemetry_loadgen -n 300 -r 50 -- host/build/tools/telemetry_ingest
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "TelemetryParse.h"
+#include "TelemetryStore.h"
+
+#define STREAM_BUFFER   4096    /* Longest line kept; longer ones are dropped */
+#define MAX_EVENTS      64
+#define HISTOGRAM_BINS  40      /* log2 of nanoseconds */
+
+typedef struct {
+    int      fd;
+    uint16_t device;
+    bool     open;
+    size_t   fill;
+    char     buffer[STREAM_BUFFER + TelemetryParse_LOOKAHEAD];
+} Stream;
+
+typedef struct {
+    uint64_t records;
+    uint64_t bytes;
+    uint64_t reads;
+    uint64_t other;         /* Lines that are not records */
+    uint64_t malformed;     /* Record lines that failed to parse */
+    uint64_t overlong;      /* Lines dropped for not fitting the stream buffer */
+    uint64_t storeErrors;
+    uint64_t parseNs;
+    uint64_t flushes;
+    uint64_t flushNs;
+    uint64_t latency[HISTOGRAM_BINS];
+    uint64_t maxLatencyNs;
+} Metrics;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+/*
+ *  ======== nowNs ========
+ */
+static uint64_t nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void stopHandler(int sig) {
+    (void)sig;
+    stopRequested = 1;
+}
+
+/*
+ *  ======== log2Bin ========
+ */
+static unsigned log2Bin(uint64_t ns) {
+    unsigned bin = ns == 0 ? 0 : 63u - (unsigned)__builtin_clzll(ns);
+
+    return bin < HISTOGRAM_BINS ? bin : HISTOGRAM_BINS - 1;
+}
+
+/*
+ *  ======== percentileUs ========
+ *  Upper edge of the histogram bin holding the given fraction of the
+ *  records since last, capped at the largest latency seen.
+ */
+static double percentileUs(const Metrics *m, const Metrics *last, double fraction) {
+    uint64_t total = 0, seen = 0;
+    unsigned bin;
+
+    for (bin = 0; bin < HISTOGRAM_BINS; bin++) {
+        total += m->latency[bin] - last->latency[bin];
+    }
+    for (bin = 0; bin < HISTOGRAM_BINS; bin++) {
+        seen += m->latency[bin] - last->latency[bin];
+        if (total != 0 && seen >= fraction * total) {
+            return (double)((2ull << bin) < m->maxLatencyNs ? (2ull << bin) : m->maxLatencyNs) / 1000.0;
+        }
+    }
+    return 0.0;
+}
+
+/*
+ *  ======== openStream ========
+ */
+static bool openStream(Stream *stream, const char *path, uint16_t device) {
+    struct termios tio;
+
+    stream->fd = strcmp(path, "-") == 0 ? dup(0) : open(path, O_RDONLY | O_NOCTTY);
+    if (stream->fd < 0) {
+        fprintf(stderr, "telemetry_ingest: %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    if (isatty(stream->fd) && tcgetattr(stream->fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, B115200);
+        cfsetospeed(&tio, B115200);
+        tcsetattr(stream->fd, TCSANOW, &tio);
+    }
+    fcntl(stream->fd, F_SETFL, fcntl(stream->fd, F_GETFL) | O_NONBLOCK);
+    stream->device = device;
+    stream->open = true;
+    stream->fill = 0;
+    return true;
+}
+
+/*
+ *  ======== parseLines ========
+ *  Parse and store every complete line in the stream buffer, keeping the
+ *  partial line at the end. Returns the number of records stored.
+ */
+static uint64_t parseLines(Stream *stream, TelemetryStore *store, Metrics *m) {
+    TelemetryParse_Record record;
+    char *line = stream->buffer;
+    char *limit = stream->buffer + stream->fill;
+    char *newline, *end;
+    uint64_t records = 0;
+
+    while ((newline = memchr(line, '\n', (size_t)(limit - line))) != NULL) {
+        end = newline - (newline > line && newline[-1] == '\r');
+        switch (TelemetryParse_line(line, end, &record)) {
+            case TelemetryParse_RECORD:
+                records++;
+                m->storeErrors += !TelemetryStore_append(store, stream->device, &record);
+                break;
+            case TelemetryParse_OTHER:
+                m->other += (end != line);
+                break;
+            case TelemetryParse_MALFORMED:
+                m->malformed++;
+                break;
+        }
+        line = newline + 1;
+    }
+
+    stream->fill = (size_t)(limit - line);
+    if (stream->fill == STREAM_BUFFER) {
+        m->overlong++;  /* No line end in a full buffer */
+        stream->fill = 0;
+    } else if (line != stream->buffer) {
+        memmove(stream->buffer, line, stream->fill);
+    }
+    return records;
+}
+
+/*
+ *  ======== serviceStream ========
+ *  Read until the stream has nothing more. Returns false at end of file.
+ */
+static bool serviceStream(Stream *stream, TelemetryStore *store, Metrics *m, uint64_t wakeNs) {
+    uint64_t start, done, records;
+    ssize_t n;
+
+    for (;;) {
+        n = read(stream->fd, stream->buffer + stream->fill, STREAM_BUFFER - stream->fill);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return n < 0 && errno == EAGAIN;  /* EOF, or EIO once a pty's writer has gone */
+        }
+        m->reads++;
+        m->bytes += (uint64_t)n;
+        stream->fill += (size_t)n;
+
+        start = nowNs();
+        records = parseLines(stream, store, m);
+        done = nowNs();
+        m->parseNs += done - start;
+        if (records != 0) {
+            m->records += records;
+            m->latency[log2Bin(done - wakeNs)] += records;
+            if (done - wakeNs > m->maxLatencyNs) {
+                m->maxLatencyNs = done - wakeNs;
+            }
+        }
+    }
+}
+
+/*
+ *  ======== report ========
+ */
+static void report(const char *label, const Metrics *m, const Metrics *last, double seconds, unsigned open) {
+    uint64_t records = m->records - last->records;
+
+    uint64_t flushes = m->flushes - last->flushes;
+
+    fprintf(stderr, "ingest %s: %u streams, %.0f rec/s, %.2f MB/s, %.1f reads/s, parse %.1f ns/rec, flush %.2f ms, "
+            "latency p50 %.1f us p99 %.1f us max %.1f us, other %llu, malformed %llu, overlong %llu, store errors %llu\n",
+            label, open, records / seconds, (m->bytes - last->bytes) / seconds / 1e6,
+            (m->reads - last->reads) / seconds,
+            records ? (double)(m->parseNs - last->parseNs) / records : 0.0,
+            flushes ? (double)(m->flushNs - last->flushNs) / flushes / 1e6 : 0.0,
+            percentileUs(m, last, 0.50), percentileUs(m, last, 0.99), m->maxLatencyNs / 1000.0,
+            (unsigned long long)m->other, (unsigned long long)m->malformed,
+            (unsigned long long)m->overlong, (unsigned long long)m->storeErrors);
+}
+
+int main(int argc, char *argv[]) {
+    const char *storePath = "telemetry.store";
+    struct epoll_event events[MAX_EVENTS];
+    struct epoll_event ev;
+    struct sigaction sa;
+    Stream *streams;
+    TelemetryStore *store;
+    Metrics metrics, last;
+    uint64_t start, lastReport, lastCommit, intervalNs = 5000000000ull, commitNs = 1000000000ull, wakeNs;
+    unsigned count, open = 0, i;
+    int epfd, opt, n;
+
+    while ((opt = getopt(argc, argv, "o:i:c:")) != -1) {
+        switch (opt) {
+            case 'o': storePath = optarg; break;
+            case 'i': intervalNs = (uint64_t)(atof(optarg) * 1e9); break;
+            case 'c': commitNs = (uint64_t)(atof(optarg) * 1e9); break;
+            default:
+                fprintf(stderr, "usage: telemetry_ingest [-o store] [-i seconds] [-c seconds] device...\n");
+                return 2;
+        }
+    }
+    count = (unsigned)(argc - optind);
+    if (count == 0 || count > UINT16_MAX) {
+        fprintf(stderr, "usage: telemetry_ingest [-o store] [-i seconds] [-c seconds] device...\n");
+        return 2;
+    }
+
+    store = TelemetryStore_open(storePath, true);
+    streams = calloc(count, sizeof(*streams));
+    epfd = epoll_create1(0);
+    if (store == NULL || streams == NULL || epfd < 0) {
+        fprintf(stderr, "telemetry_ingest: cannot open %s\n", storePath);
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        if (!openStream(&streams[i], argv[optind + i], (uint16_t)i)) {
+            continue;
+        }
+        ev.events = EPOLLIN;
+        ev.data.ptr = &streams[i];
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, streams[i].fd, &ev) != 0) {
+            fprintf(stderr, "telemetry_ingest: %s: %s\n", argv[optind + i], strerror(errno));
+            close(streams[i].fd);
+            streams[i].open = false;
+            continue;
+        }
+        open++;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = stopHandler;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    memset(&metrics, 0, sizeof(metrics));
+    last = metrics;
+    start = lastReport = lastCommit = nowNs();
+    while (open != 0 && !stopRequested) {
+        n = epoll_wait(epfd, events, MAX_EVENTS, 100);
+        wakeNs = nowNs();
+        for (i = 0; i < (unsigned)(n > 0 ? n : 0); i++) {
+            Stream *stream = events[i].data.ptr;
+
+            if (!serviceStream(stream, store, &metrics, wakeNs)) {
+                epoll_ctl(epfd, EPOLL_CTL_DEL, stream->fd, NULL);
+                close(stream->fd);
+                stream->open = false;
+                open--;
+            }
+        }
+        if (wakeNs - lastCommit >= commitNs) {
+            metrics.storeErrors += !TelemetryStore_flush(store);
+            lastCommit = nowNs();
+            metrics.flushes++;
+            metrics.flushNs += lastCommit - wakeNs;
+        }
+        if (wakeNs - lastReport >= intervalNs) {
+            report("interval", &metrics, &last, (wakeNs - lastReport) / 1e9, open);
+            last = metrics;
+            lastReport = wakeNs;
+        }
+    }
+
+    memset(&last, 0, sizeof(last));
+    report("total", &metrics, &last, (nowNs() - start) / 1e9, open);
+    fprintf(stderr, "ingest: %llu records added to %s\n", (unsigned long long)TelemetryStore_count(store), storePath);
+    if (!TelemetryStore_close(store)) {
+        fprintf(stderr, "telemetry_ingest: error writing %s\n", storePath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*
+ *  ======== telemetry_loadgen.c ========
+ *  Simulates a fleet of thermostats for load-testing telemetry_ingest.
+ *
+ *      telemetry_loadgen [-n devices] [-r records/s] [-t seconds] -- command [args...]
+ *
+ *  Creates one pty per device and runs the command with the pty paths
+ *  appended to its arguments, then writes each device's ASCII telemetry,
+ *  formatted exactly as the firmware does, to the master side at the
+ *  given rate per device (default 100 devices at 1 record/s for 10 s).
+ *  Each device has its own slowly drifting room temperature, set-point and
+ *  heater cycle. At the end the masters are closed, which the reader sees
+ *  as end of file, and the command is waited for.
+ *
+ *  Writes are non-blocking; a record that does not fit in the pty because
+ *  the reader has fallen behind is counted as dropped, not retried.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "TempConv.h"
+
+#define TICK_NS     10000000ull  /* Send what has come due every 10 ms */
+
+typedef struct {
+    int         master;
+    int         slave;
+    char        path[64];
+    uint32_t    timeCounter;
+    TempConv_Q7 temperature;
+    int         setPoint;
+    bool        heaterOn;
+    uint32_t    random;
+} Device;
+
+/*
+ *  ======== nowNs ========
+ */
+static uint64_t nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ *  ======== openDevice ========
+ *  The slave stays open here too so its raw settings hold until the
+ *  reader has opened it.
+ */
+static bool openDevice(Device *device, unsigned index) {
+    struct termios tio;
+
+    device->master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (device->master < 0 || grantpt(device->master) != 0 || unlockpt(device->master) != 0) {
+        return false;
+    }
+    snprintf(device->path, sizeof(device->path), "%s", ptsname(device->master));
+    device->slave = open(device->path, O_RDWR | O_NOCTTY);
+    if (device->slave < 0 || tcgetattr(device->slave, &tio) != 0) {
+        return false;
+    }
+    cfmakeraw(&tio);
+    tcsetattr(device->slave, TCSANOW, &tio);
+    fcntl(device->master, F_SETFL, fcntl(device->master, F_GETFL) | O_NONBLOCK);
+    fcntl(device->master, F_SETFD, FD_CLOEXEC);  /* The reader must not keep the master open */
+    fcntl(device->slave, F_SETFD, FD_CLOEXEC);
+
+    device->timeCounter = 0;
+    device->random = index * 2654435761u + 1;
+    device->temperature = (TempConv_Q7)((18 + index % 6) * 128);
+    device->setPoint = 20 + (int)(index % 5);
+    device->heaterOn = false;
+    return true;
+}
+
+/*
+ *  ======== nextRecord ========
+ *  Advance the device by one report period and format its record.
+ */
+static int nextRecord(Device *device, char *line, size_t size) {
+    char tempText[TempConv_FORMAT_LEN];
+
+    device->random = device->random * 1664525u + 1013904223u;
+    device->timeCounter++;
+    device->temperature += device->heaterOn ? 4 : -4;  /* One TMP006 LSB per report */
+    device->temperature += (TempConv_Q7)(((device->random >> 29) & 3) - 1) * 4;
+    device->heaterOn = device->temperature < device->setPoint * 128;
+    if ((device->random >> 8) % 3600 == 0) {
+        device->setPoint += (device->random & 0x10000) ? 1 : -1;
+    }
+
+    TempConv_format(tempText, device->temperature);
+    return snprintf(line, size, "<%s,%02d,%d,%04u>\r\n", tempText, device->setPoint,
+                    device->heaterOn ? 1 : 0, (unsigned)device->timeCounter);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned devices = 100, i;
+    double rate = 1.0, seconds = 10.0;
+    Device *fleet;
+    char **args;
+    char line[64];
+    uint64_t start, now, due, sent = 0, dropped = 0;
+    int opt, len, status;
+    pid_t child;
+
+    while ((opt = getopt(argc, argv, "n:r:t:")) != -1) {
+        switch (opt) {
+            case 'n': devices = (unsigned)atoi(optarg); break;
+            case 'r': rate = atof(optarg); break;
+            case 't': seconds = atof(optarg); break;
+            default:
+                fprintf(stderr, "usage: telemetry_loadgen [-n devices] [-r records/s] [-t seconds] -- command [args...]\n");
+                return 2;
+        }
+    }
+    if (optind >= argc || devices == 0 || rate <= 0.0) {
+        fprintf(stderr, "usage: telemetry_loadgen [-n devices] [-r records/s] [-t seconds] -- command [args...]\n");
+        return 2;
+    }
+
+    fleet = calloc(devices, sizeof(*fleet));
+    args = calloc((size_t)(argc - optind) + devices + 1, sizeof(*args));
+    if (fleet == NULL || args == NULL) {
+        return 1;
+    }
+    for (i = 0; i < devices; i++) {
+        if (!openDevice(&fleet[i], i)) {
+            fprintf(stderr, "telemetry_loadgen: pty %u: %s\n", i, strerror(errno));
+            return 1;
+        }
+    }
+
+    for (i = 0; i < (unsigned)(argc - optind); i++) {
+        args[i] = argv[optind + i];
+    }
+    for (i = 0; i < devices; i++) {
+        args[argc - optind + i] = fleet[i].path;
+    }
+    child = fork();
+    if (child == 0) {
+        execvp(args[0], args);
+        perror(args[0]);
+        _exit(127);
+    }
+    usleep(200000);  /* Let the reader open every pty first */
+
+    start = nowNs();
+    for (;;) {
+        now = nowNs();
+        if (now - start >= (uint64_t)(seconds * 1e9)) {
+            break;
+        }
+        /* Records each device owes so far, sent round robin across the fleet */
+        due = (uint64_t)((now - start) / 1e9 * rate);
+        for (i = 0; i < devices; i++) {
+            while (fleet[i].timeCounter < due) {
+                len = nextRecord(&fleet[i], line, sizeof(line));
+                if (write(fleet[i].master, line, (size_t)len) == len) {
+                    sent++;
+                } else {
+                    dropped++;
+                }
+            }
+        }
+        usleep(TICK_NS / 1000);
+    }
+
+    for (i = 0; i < devices; i++) {
+        close(fleet[i].slave);
+    }
+    usleep(200000);  /* Give the reader time to drain */
+    for (i = 0; i < devices; i++) {
+        close(fleet[i].master);
+    }
+    waitpid(child, &status, 0);
+    fprintf(stderr, "loadgen: %u devices, %llu records sent (%.0f rec/s), %llu dropped\n", devices,
+            (unsigned long long)sent, sent / seconds, (unsigned long long)dropped);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
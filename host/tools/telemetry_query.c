@@ -0,0 +1,154 @@
+/*
+ *  ======== telemetry_query.c ========
+ *  Range query over a TelemetryStore written by telemetry_ingest.
+ *
+ *      telemetry_query [-p] store device [from [to]]
+ *
+ *  Summarizes the device's rows with a time counter in [from, to]
+ *  (default all): count, room temperature minimum, mean and maximum,
+ *  set-point range and heater duty. -p also prints each row as an ASCII
+ *  telemetry line. The report on stderr gives the time to open the store
+ *  and to scan it, and how many blocks the time index let the scan skip.
+ *
+ *  The store may be queried while telemetry_ingest is still appending;
+ *  the query sees the rows of the last flush.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "TelemetryStore.h"
+#include "TempConv.h"
+
+typedef struct {
+    uint32_t from;
+    uint32_t to;
+    bool     print;
+    uint64_t rows;
+    int64_t  temperatureSum;
+    int16_t  temperatureMin;
+    int16_t  temperatureMax;
+    int16_t  setPointMin;
+    int16_t  setPointMax;
+    uint64_t heaterRows;
+} Query;
+
+/*
+ *  ======== nowNs ========
+ */
+static uint64_t nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ *  ======== printRow ========
+ */
+static void printRow(const TelemetryStore_Columns *c, size_t i) {
+    char tempText[TempConv_FORMAT_LEN];
+    unsigned zone = c->flags[i] >> TelemetryStore_FLAG_ZONE_SHIFT;
+
+    TempConv_format(tempText, c->temperature[i]);
+    printf("<%s,%02d,%d,%04u", tempText, c->setPoint[i],
+           (c->flags[i] & TelemetryStore_FLAG_HEATER) ? 1 : 0, (unsigned)c->time[i]);
+    if (zone != 0) {
+        printf(",%u", zone);
+    }
+    printf(">\n");
+}
+
+/*
+ *  ======== scanBlock ========
+ *  Filter one block on the time column and fold in the rows that match.
+ */
+static bool scanBlock(void *arg, const TelemetryStore_Columns *c) {
+    Query *q = arg;
+    size_t i;
+
+    for (i = 0; i < c->count; i++) {
+        if (c->time[i] < q->from || c->time[i] > q->to) {
+            continue;
+        }
+        if (q->rows == 0) {
+            q->temperatureMin = q->temperatureMax = c->temperature[i];
+            q->setPointMin = q->setPointMax = c->setPoint[i];
+        }
+        q->rows++;
+        q->temperatureSum += c->temperature[i];
+        q->temperatureMin = c->temperature[i] < q->temperatureMin ? c->temperature[i] : q->temperatureMin;
+        q->temperatureMax = c->temperature[i] > q->temperatureMax ? c->temperature[i] : q->temperatureMax;
+        q->setPointMin = c->setPoint[i] < q->setPointMin ? c->setPoint[i] : q->setPointMin;
+        q->setPointMax = c->setPoint[i] > q->setPointMax ? c->setPoint[i] : q->setPointMax;
+        q->heaterRows += c->flags[i] & TelemetryStore_FLAG_HEATER;
+        if (q->print) {
+            printRow(c, i);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    TelemetryStore *store;
+    TelemetryStore_ScanStats stats = { 0, 0, 0 };
+    Query q = { 0, UINT32_MAX, false, 0, 0, 0, 0, 0, 0, 0 };
+    char minText[TempConv_FORMAT_LEN], meanText[TempConv_FORMAT_LEN], maxText[TempConv_FORMAT_LEN];
+    uint64_t start, opened, scanned;
+    unsigned device;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p")) != -1) {
+        if (opt != 'p') {
+            fprintf(stderr, "usage: telemetry_query [-p] store device [from [to]]\n");
+            return 2;
+        }
+        q.print = true;
+    }
+    if (argc - optind < 2 || argc - optind > 4) {
+        fprintf(stderr, "usage: telemetry_query [-p] store device [from [to]]\n");
+        return 2;
+    }
+    device = (unsigned)strtoul(argv[optind + 1], NULL, 0);
+    if (argc - optind > 2) {
+        q.from = (uint32_t)strtoul(argv[optind + 2], NULL, 0);
+    }
+    if (argc - optind > 3) {
+        q.to = (uint32_t)strtoul(argv[optind + 3], NULL, 0);
+    }
+
+    start = nowNs();
+    store = TelemetryStore_open(argv[optind], false);
+    if (store == NULL) {
+        fprintf(stderr, "telemetry_query: cannot open %s: %s\n", argv[optind], strerror(errno));
+        return 1;
+    }
+    if (device >= TelemetryStore_MAX_DEVICES || TelemetryStore_rows(store, (uint16_t)device) == 0) {
+        fprintf(stderr, "telemetry_query: no rows for device %u in %s\n", device, argv[optind]);
+        return 1;
+    }
+    opened = nowNs();
+    TelemetryStore_scan(store, (uint16_t)device, q.from, q.to, scanBlock, &q, &stats);
+    scanned = nowNs();
+
+    if (q.rows != 0) {
+        TempConv_format(minText, q.temperatureMin);
+        TempConv_format(meanText, (TempConv_Q7)(q.temperatureSum / (int64_t)q.rows));
+        TempConv_format(maxText, q.temperatureMax);
+        printf("device %u, time %u-%u: %llu rows, temperature %s/%s/%s C min/mean/max, "
+               "set-point %d-%d C, heater on %.1f%%\n", device, (unsigned)q.from, (unsigned)q.to,
+               (unsigned long long)q.rows, minText, meanText, maxText, q.setPointMin, q.setPointMax,
+               100.0 * q.heaterRows / q.rows);
+    } else {
+        printf("device %u, time %u-%u: no rows\n", device, (unsigned)q.from, (unsigned)q.to);
+    }
+    fprintf(stderr, "query: open %.1f us, scan %.1f us, %llu of %llu blocks skipped by the time index, %llu rows scanned\n",
+            (opened - start) / 1e3, (scanned - opened) / 1e3, (unsigned long long)stats.blocksSkipped,
+            (unsigned long long)stats.blocks, (unsigned long long)stats.rowsScanned);
+    TelemetryStore_close(store);
+    return 0;
+}
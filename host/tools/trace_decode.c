@@ -0,0 +1,344 @@
+/*
+ *  ======== trace_decode.c ========
+ *  Decodes the firmware's binary trace (Trace.h) into one line per record.
+ *
+ *      trace_decode [-e firmware.out] [file]
+ *
+ *  The input (default stdin) is either a memory dump holding Trace_buffer,
+ *  found by its magic word, or UART output with the "!t," lines of a 't'
+ *  drain; other lines in it, such as telemetry, are skipped.
+ *
+ *  Event names and formats are read from the .log_data section of the
+ *  firmware's ELF image given with -e (the TI .out file, or the host
+ *  build). Without it events are printed by number with their arguments
+ *  in hex.
+ *
+ *  Times are microseconds from the first record, with the 32-bit cycle
+ *  counter unwrapped; a record more than one counter period after the
+ *  one before it is mistimed. A jump in the sequence number is reported
+ *  as records lost, overwritten before the drain or dump reached them.
+ *
+ *      host/build/thermostat | host/build/tools/trace_decode -e host/build/thermostat
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Trace.h"
+
+#define MAX_EVENTS  256
+
+typedef struct {
+    unsigned long records;
+    unsigned long lost;
+    unsigned long counts[MAX_EVENTS];
+    uint32_t      countsPerUs;
+    uint64_t      time;         /* Unwrapped cycle count of the last record */
+    uint32_t      lastTime;
+    uint16_t      lastSequence;
+} Decoder;
+
+static Trace_EventInfo events[MAX_EVENTS];
+static unsigned eventCount = 0;
+
+static uint16_t getLe16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t getLe32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t getLe64(const uint8_t *p) {
+    return (uint64_t)getLe32(p) | ((uint64_t)getLe32(p + 4) << 32);
+}
+
+/*
+ *  ======== readFile ========
+ *  Whole file, or stdin for NULL, into a malloc'd buffer.
+ */
+static uint8_t *readFile(const char *path, size_t *size) {
+    FILE *f = path == NULL ? stdin : fopen(path, "rb");
+    uint8_t *data = NULL, *grown;
+    size_t capacity = 0, n;
+
+    *size = 0;
+    if (f == NULL) {
+        return NULL;
+    }
+    do {
+        if (*size == capacity) {
+            capacity = capacity ? 2 * capacity : 65536;
+            grown = realloc(data, capacity);
+            if (grown == NULL) {
+                free(data);
+                data = NULL;
+                break;
+            }
+            data = grown;
+        }
+        n = fread(data + *size, 1, capacity - *size, f);
+        *size += n;
+    } while (n != 0);
+    if (f != stdin) {
+        fclose(f);
+    }
+    return data;
+}
+
+/*
+ *  ======== formatValid ========
+ *  A format is used only if its conversions are all integer ones, since
+ *  it comes from a file and is handed to printf with two unsigned ints.
+ */
+static bool formatValid(const char *format) {
+    const char *p = format;
+    int conversions = 0;
+
+    while ((p = strchr(p, '%')) != NULL) {
+        p++;
+        if (*p == '%') {
+            p++;
+            continue;
+        }
+        p += strspn(p, "-+ #0123456789");
+        if (*p == '\0' || strchr("diuxXc", *p) == NULL) {
+            return false;
+        }
+        conversions++;
+        p++;
+    }
+    return conversions <= 2;
+}
+
+/*
+ *  ======== loadEvents ========
+ *  Read the event table from the .log_data section of an ELF32 or ELF64
+ *  little-endian image.
+ */
+static bool loadEvents(const char *path) {
+    size_t size, i;
+    uint8_t *elf = readFile(path, &size);
+    uint64_t shoff, offset, length;
+    unsigned shentsize, shnum, shstrndx;
+    const uint8_t *sh, *names;
+    bool is64;
+    Trace_EventInfo info;
+
+    if (elf == NULL || size < 64 || memcmp(elf, "\177ELF", 4) != 0 || elf[5] != 1) {
+        free(elf);
+        return false;
+    }
+    is64 = elf[4] == 2;
+    shoff = is64 ? getLe64(elf + 0x28) : getLe32(elf + 0x20);
+    shentsize = getLe16(elf + (is64 ? 0x3A : 0x2E));
+    shnum = getLe16(elf + (is64 ? 0x3C : 0x30));
+    shstrndx = getLe16(elf + (is64 ? 0x3E : 0x32));
+    if (shstrndx >= shnum || shoff + (uint64_t)shnum * shentsize > size) {
+        free(elf);
+        return false;
+    }
+    sh = elf + shoff + (uint64_t)shstrndx * shentsize;
+    names = elf + (is64 ? getLe64(sh + 0x18) : getLe32(sh + 0x10));
+
+    for (i = 0; i < shnum; i++) {
+        sh = elf + shoff + i * shentsize;
+        if (strcmp((const char *)names + getLe32(sh), ".log_data") != 0) {
+            continue;
+        }
+        offset = is64 ? getLe64(sh + 0x18) : getLe32(sh + 0x10);
+        length = is64 ? getLe64(sh + 0x20) : getLe32(sh + 0x14);
+        if (offset + length > size) {
+            break;
+        }
+        for (; length >= sizeof(info) && eventCount < MAX_EVENTS; length -= sizeof(info), offset += sizeof(info)) {
+            memcpy(&info, elf + offset, sizeof(info));
+            info.id = getLe16(elf + offset);
+            info.args = getLe16(elf + offset + 2);
+            info.name[Trace_NAME_LEN - 1] = '\0';
+            info.format[Trace_FORMAT_LEN - 1] = '\0';
+            if (info.id != eventCount) {
+                break;  /* Not part of the table */
+            }
+            if (!formatValid(info.format)) {
+                info.format[0] = '\0';
+            }
+            events[eventCount++] = info;
+        }
+        break;
+    }
+    free(elf);
+    return eventCount != 0;
+}
+
+/*
+ *  ======== printRecord ========
+ */
+static void printRecord(Decoder *d, const Trace_Record *r) {
+    uint16_t gap;
+
+    if (d->records != 0) {
+        gap = (uint16_t)(r->sequence - d->lastSequence - 1);
+        if (gap != 0) {
+            printf("  -- %u records lost\n", gap);
+            d->lost += gap;
+        }
+        d->time += r->time - d->lastTime;
+    }
+    d->lastTime = r->time;
+    d->lastSequence = r->sequence;
+    d->records++;
+    d->counts[r->event % MAX_EVENTS]++;
+
+    printf("%12.1f  %5u  ", (double)d->time / d->countsPerUs, r->sequence);
+    if (r->event < eventCount) {
+        printf("%-12s  ", events[r->event].name);
+        if (events[r->event].format[0] != '\0') {
+            printf(events[r->event].format, (unsigned)r->arg0, (unsigned)r->arg1);
+            printf("\n");
+            return;
+        }
+    } else {
+        printf("event %-6u  ", r->event);
+    }
+    printf("0x%08x 0x%08x\n", (unsigned)r->arg0, (unsigned)r->arg1);
+}
+
+/*
+ *  ======== getRecord ========
+ *  One record as laid out in target memory, little-endian.
+ */
+static void getRecord(const uint8_t *p, Trace_Record *r) {
+    r->time = getLe32(p);
+    r->event = getLe16(p + 4);
+    r->sequence = getLe16(p + 6);
+    r->arg0 = getLe32(p + 8);
+    r->arg1 = getLe32(p + 12);
+}
+
+/*
+ *  ======== hexRecord ========
+ *  Parse the 32 hex digits of a "!t," line. Returns false if malformed.
+ */
+static bool hexRecord(const char *text, Trace_Record *r) {
+    uint8_t bytes[sizeof(Trace_Record)];
+    unsigned i, hi, lo;
+
+    for (i = 0; i < sizeof(bytes); i++) {
+        if (sscanf(text + 2 * i, "%1x%1x", &hi, &lo) != 2) {
+            return false;
+        }
+        bytes[i] = (uint8_t)(hi << 4 | lo);
+    }
+    getRecord(bytes, r);
+    return true;
+}
+
+/*
+ *  ======== decodeDump ========
+ *  Decode the ring at the first magic word in a memory dump, oldest first.
+ */
+static bool decodeDump(Decoder *d, const uint8_t *data, size_t size) {
+    size_t at, recordSize, capacity, i;
+    uint32_t head, first;
+    Trace_Record r;
+
+    for (at = 0; at + 16 <= size; at += 4) {
+        if (getLe32(data + at) == Trace_MAGIC) {
+            break;
+        }
+    }
+    if (at + 16 > size) {
+        return false;
+    }
+    recordSize = getLe16(data + at + 4);
+    capacity = getLe16(data + at + 6);
+    d->countsPerUs = getLe32(data + at + 8) ? getLe32(data + at + 8) : Trace_COUNTS_PER_US;
+    head = getLe32(data + at + 12);
+    if (recordSize < sizeof(Trace_Record) || capacity == 0 || at + 16 + capacity * recordSize > size) {
+        fprintf(stderr, "trace_decode: trace header at offset %zu is damaged or cut off\n", at);
+        return false;
+    }
+
+    first = head > capacity ? head - (uint32_t)capacity : 0;
+    if (first != 0) {
+        printf("  -- %u records overwritten before the dump\n", (unsigned)first);
+        d->lost += first;
+    }
+    for (i = first; i != head; i++) {
+        getRecord(data + at + 16 + (i % capacity) * recordSize, &r);
+        printRecord(d, &r);
+    }
+    return true;
+}
+
+/*
+ *  ======== decodeLines ========
+ *  Decode every "!t," line in UART output. Returns the number found.
+ */
+static unsigned long decodeLines(Decoder *d, const uint8_t *data, size_t size) {
+    const char *p = (const char *)data, *end = p + size, *mark;
+    unsigned long found = 0;
+    Trace_Record r;
+
+    while ((mark = memmem(p, (size_t)(end - p), "!t,", 3)) != NULL) {
+        p = mark + 3;
+        if (end - p >= 2 * (long)sizeof(Trace_Record) && hexRecord(p, &r)) {
+            printRecord(d, &r);
+            found++;
+        }
+    }
+    return found;
+}
+
+int main(int argc, char *argv[]) {
+    Decoder d;
+    uint8_t *data;
+    size_t size;
+    unsigned i;
+    int opt;
+
+    memset(&d, 0, sizeof(d));
+    d.countsPerUs = Trace_COUNTS_PER_US;
+    while ((opt = getopt(argc, argv, "e:")) != -1) {
+        if (opt != 'e') {
+            fprintf(stderr, "usage: trace_decode [-e firmware.out] [file]\n");
+            return 2;
+        }
+        if (!loadEvents(optarg)) {
+            fprintf(stderr, "trace_decode: no trace event table in %s\n", optarg);
+            return 1;
+        }
+    }
+    if (argc - optind > 1) {
+        fprintf(stderr, "usage: trace_decode [-e firmware.out] [file]\n");
+        return 2;
+    }
+    data = readFile(optind < argc ? argv[optind] : NULL, &size);
+    if (data == NULL) {
+        fprintf(stderr, "trace_decode: cannot read %s\n", optind < argc ? argv[optind] : "stdin");
+        return 1;
+    }
+
+    if (decodeLines(&d, data, size) == 0 && !decodeDump(&d, data, size)) {
+        fprintf(stderr, "trace_decode: no trace records found\n");
+        free(data);
+        return 1;
+    }
+    fprintf(stderr, "trace: %lu records over %.1f ms, %lu lost", d.records,
+            (double)d.time / d.countsPerUs / 1000.0, d.lost);
+    for (i = 0; i < MAX_EVENTS; i++) {
+        if (d.counts[i] != 0 && i < eventCount) {
+            fprintf(stderr, ", %s %lu", events[i].name, d.counts[i]);
+        } else if (d.counts[i] != 0) {
+            fprintf(stderr, ", event %u %lu", i, d.counts[i]);
+        }
+    }
+    fprintf(stderr, "\n");
+    free(data);
+    return 0;
+}